@@ -0,0 +1,72 @@
+#include "circuit_optimizer/CircuitOptimizer.hpp"
+#include "dd/EquivalenceChecking.hpp"
+#include "dd/FunctionalityConstruction.hpp"
+#include "dd/Package.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Compares the alternating equivalence checker with building and comparing
+// both functionalities, e.g.
+//   ./build/apps/ec circuits/experiments/revLib/alu4_201.real --sift
+// If only one circuit is given, it is compared to an optimized version of
+// itself.
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Usage: " << static_cast<std::string>(argv[0])
+              << " <filename> [filename] [--sift]\r\n";
+    return 0;
+  }
+  dd::EquivalenceCheckingConfig config{};
+  std::string fileName1{};
+  std::string fileName2{};
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--sift") {
+      config.reorder = true;
+    } else if (fileName1.empty()) {
+      fileName1 = arg;
+    } else {
+      fileName2 = arg;
+    }
+  }
+
+  const qc::QuantumComputation qc1(fileName1);
+  auto qc2 = fileName2.empty() ? qc1 : qc::QuantumComputation(fileName2);
+  if (fileName2.empty()) {
+    qc::CircuitOptimizer::swapReconstruction(qc2);
+    qc::CircuitOptimizer::singleQubitGateFusion(qc2);
+    qc::CircuitOptimizer::removeIdentities(qc2);
+  }
+  std::cout << fileName1 << " (" << qc1.size() << " gates) vs. "
+            << (fileName2.empty() ? "optimized" : fileName2) << " ("
+            << qc2.size() << " gates), " << qc1.getNqubits() << " qubits\r\n";
+
+  {
+    auto dd = std::make_unique<dd::Package<>>(qc1.getNqubits());
+    const auto start = std::chrono::steady_clock::now();
+    const auto e1 = dd::buildFunctionality(&qc1, *dd);
+    const auto e2 = dd::buildFunctionality(&qc2, *dd);
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << "construction:\t"
+              << std::chrono::duration<double>(end - start).count() << "s,\t"
+              << (e1 == e2 ? "equivalent" : "not equivalent")
+              << ",\tpeak active nodes: "
+              << dd->mUniqueTable.getPeakNumActiveEntries() << "\r\n";
+  }
+
+  auto dd = std::make_unique<dd::Package<>>(qc1.getNqubits());
+  const auto result = dd::checkEquivalence(&qc1, &qc2, *dd, config);
+  std::cout << "alternating:\t" << result.runtime << "s,\t"
+            << (result.equivalence == dd::EquivalenceCriterion::NotEquivalent
+                    ? "not equivalent"
+                    : "equivalent")
+            << (result.earlyExit ? " (early exit)" : "")
+            << ",\tpeak active nodes: " << result.peakActiveNodes
+            << ",\tpeak intermediate size: " << result.peakNodes
+            << ",\treorderings: " << result.reorderings << "\r\n";
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include "dd/FunctionalityConstruction.hpp"
+#include "dd/Package.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Compares the per-gate functionality construction with the construction after
+// gate fusion for different block sizes, e.g.
+//   ./build/apps/fusion circuits/experiments/revLib/alu4_201.real 2 3 4
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Usage: " << static_cast<std::string>(argv[0])
+              << " <filename> [block sizes...]\r\n";
+    return 0;
+  }
+  const std::string fileName = argv[1];
+  std::vector<std::size_t> blockSizes{};
+  for (int i = 2; i < argc; ++i) {
+    blockSizes.emplace_back(std::stoul(argv[i]));
+  }
+  if (blockSizes.empty()) {
+    blockSizes = {2U, 3U, 4U};
+  }
+
+  const qc::QuantumComputation qc(fileName);
+  const auto run = [&qc](const std::string& name, auto&& build) {
+    auto dd = std::make_unique<dd::Package<>>(qc.getNqubits());
+    const auto start = std::chrono::steady_clock::now();
+    const auto e = build(*dd);
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << name << ":\t"
+              << std::chrono::duration<double>(end - start).count() << "s,\t"
+              << "dd size: " << e.size() << "\r\n";
+  };
+
+  std::cout << fileName << " (" << qc.getNqubits() << " qubits, " << qc.size()
+            << " gates)\r\n";
+  run("per-gate", [&qc](auto& dd) { return dd::buildFunctionality(&qc, dd); });
+  for (const auto blockSize : blockSizes) {
+    run("fused(" + std::to_string(blockSize) + ")",
+        [&qc, blockSize](auto& dd) {
+          return dd::buildFunctionalityFused(&qc, dd, blockSize);
+        });
+  }
+  return 0;
+}
@@ -0,0 +1,46 @@
+#include "dd/NoiseFunctionality.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Reports the throughput of the stochastic noise simulation for an increasing
+// number of threads, e.g.
+//   ./build/apps/noise circuits/experiments/revLib/alu4_201.real 1000
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Usage: " << static_cast<std::string>(argv[0])
+              << " <filename> [trajectories] [noise effects]\r\n";
+    return 0;
+  }
+  const std::string fileName = argv[1];
+  const std::size_t trajectories = argc > 2 ? std::stoul(argv[2]) : 1000U;
+  const std::string noiseEffects = argc > 3 ? argv[3] : "APD";
+
+  const qc::QuantumComputation qc(fileName);
+  std::cout << fileName << " (" << qc.getNqubits() << " qubits, " << qc.size()
+            << " gates), " << trajectories << " trajectories\r\n";
+
+  const auto maxThreads =
+      static_cast<std::size_t>(std::thread::hardware_concurrency());
+  for (std::size_t threads = 1U;; threads *= 2U) {
+    threads = std::min(threads, std::max<std::size_t>(1U, maxThreads));
+    const auto start = std::chrono::steady_clock::now();
+    const auto histogram = dd::simulateStochasticTrajectories(
+        qc, trajectories, 1U, 0.001, 0.002, 2., noiseEffects, 42U, threads);
+    const auto end = std::chrono::steady_clock::now();
+    const auto runtime = std::chrono::duration<double>(end - start).count();
+    std::cout << threads << " thread(s):\t" << runtime << "s,\t"
+              << static_cast<double>(trajectories) / runtime
+              << " trajectories/s,\t" << histogram.size()
+              << " distinct outcomes\r\n";
+    if (threads >= maxThreads) {
+      break;
+    }
+  }
+  return 0;
+}
@@ -39,6 +39,10 @@ else()
   endif()
 endif()
 
+# the DD package uses threads for parallel operations
+set(THREADS_PREFER_PTHREAD_FLAG ON)
+find_package(Threads REQUIRED)
+
 option(USE_SYSTEM_BOOST "Whether to try to use the system Boost installation" OFF)
 set(BOOST_MIN_VERSION
     1.80.0
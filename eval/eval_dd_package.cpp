@@ -402,6 +402,30 @@ protected:
     }
   }
 
+  void runParallelMultiplication() {
+    const std::array nqubits = {16U, 18U, 20U};
+    const std::array<std::size_t, 4> threads = {1U, 2U, 4U, 8U};
+    std::cout << "Running parallel QFT squaring..." << '\n';
+    for (const auto& nq : nqubits) {
+      auto qc = qc::QFT(nq, false);
+      for (const auto& t : threads) {
+        auto exp = std::make_unique<FunctionalityConstructionExperiment>();
+        exp->dd = std::make_unique<Package<>>(nq);
+        auto f = buildFunctionality(&qc, *(exp->dd));
+        exp->dd->incRef(f);
+        const auto start = std::chrono::high_resolution_clock::now();
+        exp->func = exp->dd->multiplyParallel(f, f, t);
+        const auto end = std::chrono::high_resolution_clock::now();
+        exp->runtime =
+            std::chrono::duration_cast<std::chrono::duration<double>>(end -
+                                                                      start);
+        exp->stats = dd::getStatistics(exp->dd.get());
+        verifyAndSave("QFT", "ParallelMultiply_" + std::to_string(t), qc,
+                      *exp);
+      }
+    }
+  }
+
 public:
   explicit BenchmarkDDPackage(std::string filename)
       : inputFilename(std::move(filename)) {};
@@ -414,6 +438,7 @@ public:
     runGrover();
     runQPE();
     runRandomClifford();
+    runParallelMultiplication();
   }
 };
 
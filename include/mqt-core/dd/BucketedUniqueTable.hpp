@@ -0,0 +1,653 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Edge.hpp"
+#include "dd/MemoryManager.hpp"
+#include "dd/Node.hpp"
+#include "dd/statistics/UniqueTableStatistics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dd {
+
+/**
+ * @brief Open-addressing variant of the UniqueTable
+ * @details Instead of chaining nodes through their `next` pointer, every
+ * variable owns an array of cache-line sized buckets. Each bucket stores up to
+ * `SLOTS` node pointers together with a one-byte fingerprint per slot. A
+ * lookup first compares all fingerprints of a bucket at once (SWAR, i.e., SIMD
+ * within a 64-bit register) and only dereferences nodes whose fingerprint
+ * matches. Full buckets overflow into the next bucket (linear probing). Each
+ * bucket counts how many entries overflowed past it, so that a probe sequence
+ * can stop at the first bucket nobody overflowed from. Most misses thus
+ * resolve within a single cache line.
+ *
+ * The table exposes the same interface as UniqueTable (including the
+ * extensions used by the reordering routines) and can be selected through
+ * `DDPackageConfig::UT_OPEN_ADDRESSING`.
+ * @tparam Node class of nodes to provide/store
+ * @tparam NBUCKET number of node slots the chained table would use per
+ * variable (has to be a power of two). The initial number of buckets is
+ * chosen such that the memory footprint matches the chained table.
+ */
+template <class Node, std::size_t NBUCKET = 32768> class BucketedUniqueTable {
+
+  static_assert(
+      std::disjunction_v<std::is_same<Node, vNode>, std::is_same<Node, mNode>,
+                         std::is_same<Node, dNode>>,
+      "Node type must be one of vNode, mNode, dNode");
+  static_assert((NBUCKET & (NBUCKET - 1)) == 0,
+                "NBUCKET must be a power of two");
+
+public:
+  /// The number of node slots per bucket
+  static constexpr std::size_t SLOTS = 7U;
+
+  /**
+   * @brief A single cache-line sized bucket
+   * @details The first seven bytes of `meta` hold the fingerprints of the
+   * slots (zero marks an empty slot), the last byte counts the entries that
+   * overflowed past this bucket (saturating).
+   */
+  struct alignas(64) Bucket {
+    std::uint64_t meta = 0U;
+    std::array<Node*, SLOTS> nodes{};
+  };
+  static_assert(sizeof(Bucket) == 64U, "Bucket must fit into a cache line");
+
+  /// Typedef for the table of a single variable
+  using Table = std::vector<Bucket>;
+
+  /// The initial number of buckets per variable
+  static constexpr std::size_t INITIAL_BUCKETS =
+      std::max<std::size_t>(1U, NBUCKET * sizeof(Node*) / sizeof(Bucket));
+
+  /// @see UniqueTable::INITIAL_GC_LIMIT
+  static constexpr std::size_t INITIAL_GC_LIMIT = 131072U;
+
+  /**
+   * @brief The default constructor
+   * @param nv The number of variables
+   * @param manager The memory manager to use for allocating new nodes.
+   * @param initialGCLim The initial garbage collection limit.
+   */
+  explicit BucketedUniqueTable(const std::size_t nv,
+                               MemoryManager<Node>& manager,
+                               std::size_t initialGCLim = INITIAL_GC_LIMIT)
+      : nvars(nv), tables(nv, Table(INITIAL_BUCKETS)), memoryManager(&manager),
+        initialGCLimit(initialGCLim) {
+    for (auto& stat : stats) {
+      stat.entrySize = sizeof(Bucket);
+      stat.numBuckets = INITIAL_BUCKETS;
+    }
+  }
+
+  void resize(std::size_t nq) {
+    nvars = nq;
+    tables.resize(nq, Table(INITIAL_BUCKETS));
+    stats.resize(nq);
+    for (std::size_t v = 0U; v < nq; ++v) {
+      stats[v].entrySize = sizeof(Bucket);
+      stats[v].numBuckets = tables[v].size();
+    }
+  }
+
+  /**
+   * @brief The hash function for the hash table.
+   * @details Combines the hashes of the edges of the node just like
+   * UniqueTable::hash. The result is truncated to 31 bits so that it can be
+   * passed around as `int` (see alterUniqueTable). The low bits select the
+   * home bucket, bits 24 to 30 form the fingerprint.
+   * @param p The node to hash.
+   * @returns The hash value of the node.
+   */
+  static std::size_t hash(const Node* p) {
+    static constexpr std::size_t MASK = (1ULL << 31U) - 1U;
+    std::size_t key = 0U;
+    for (std::size_t i = 0U; i < p->e.size(); ++i) {
+      qc::hashCombine(key, std::hash<Edge<Node>>{}(p->e[i]));
+    }
+    key &= MASK;
+    return key;
+  }
+
+  /// Get a reference to the table
+  [[nodiscard]] const auto& getTables() const { return tables; }
+
+  /// Get a reference to the statistics
+  [[nodiscard]] const auto& getStats() const noexcept { return stats; }
+
+  /// Get a reference to individual statistics
+  [[nodiscard]] const auto& getStats(const std::size_t idx) const noexcept {
+    return stats.at(idx);
+  }
+
+  /// Get a JSON object with the statistics
+  [[nodiscard]] nlohmann::basic_json<>
+  getStatsJson(const bool includeIndividualTables = false) const {
+    if (std::all_of(stats.begin(), stats.end(),
+                    [](const UniqueTableStatistics& stat) {
+                      return stat.peakNumEntries == 0U;
+                    })) {
+      return "unused";
+    }
+
+    UniqueTableStatistics totalStats;
+    for (const auto& stat : stats) {
+      totalStats.entrySize = std::max(totalStats.entrySize, stat.entrySize);
+      totalStats.numBuckets += stat.numBuckets;
+      totalStats.numEntries += stat.numEntries;
+      totalStats.peakNumEntries += stat.peakNumEntries;
+      totalStats.collisions += stat.collisions;
+      totalStats.hits += stat.hits;
+      totalStats.lookups += stat.lookups;
+      totalStats.inserts += stat.inserts;
+      totalStats.numActiveEntries += stat.numActiveEntries;
+      totalStats.peakNumActiveEntries += stat.peakNumActiveEntries;
+      totalStats.gcRuns = std::max(totalStats.gcRuns, stat.gcRuns);
+    }
+
+    nlohmann::basic_json<> j;
+    j["total"] = totalStats.json();
+    if (includeIndividualTables) {
+      std::size_t v = 0U;
+      for (const auto& stat : stats) {
+        j[std::to_string(v)] = stat.json();
+        ++v;
+      }
+    }
+    return j;
+  }
+
+  /// Get the total number of entries
+  [[nodiscard]] std::size_t getNumEntries() const noexcept {
+    return std::accumulate(
+        stats.begin(), stats.end(), std::size_t{0},
+        [](const std::size_t& sum, const UniqueTableStatistics& stat) {
+          return sum + stat.numEntries;
+        });
+  }
+
+  /// Get the total number of active entries
+  [[nodiscard]] std::size_t getNumActiveEntries() const noexcept {
+    return std::accumulate(
+        stats.begin(), stats.end(), std::size_t{0},
+        [](const std::size_t& sum, const UniqueTableStatistics& stat) {
+          return sum + stat.numActiveEntries;
+        });
+  }
+
+  /// Get the peak total number of active entries
+  [[nodiscard]] std::size_t getPeakNumActiveEntries() const noexcept {
+    return std::accumulate(
+        stats.begin(), stats.end(), std::size_t{0},
+        [](const std::size_t& sum, const UniqueTableStatistics& stat) {
+          return sum + stat.peakNumActiveEntries;
+        });
+  }
+
+  static bool nodesAreEqual(const Node* p, const Node* q) {
+    if constexpr (std::is_same_v<Node, dNode>) {
+      return (p->e == q->e && (p->flags == q->flags));
+    } else {
+      return p->e == q->e;
+    }
+  }
+
+  /// @see UniqueTable::lookup
+  Node* lookup(Node* p) {
+    // there are unique terminal nodes
+    if (Node::isTerminal(p)) {
+      return p;
+    }
+
+    const auto key = hash(p);
+    const auto v = p->v;
+    ++stats[v].lookups;
+
+    if (auto* hashedNode = searchTable(p, key); !Node::isTerminal(hashedNode)) {
+      return hashedNode;
+    }
+
+    if ((stats[v].numEntries + 1U) * MAX_LOAD_DEN >
+        tables[v].size() * SLOTS * MAX_LOAD_NUM) {
+      grow(v);
+    }
+    insert(tables[v], p, key);
+    stats[v].trackInsert();
+    if (incremental) {
+      candidates.emplace_back(p);
+    }
+    return p;
+  }
+
+  /// @see UniqueTable::incRef
+  [[nodiscard]] bool incRef(Node* p) noexcept {
+    const auto inc = ::dd::incRef(p);
+    if (inc && p->ref == 1U) {
+      stats[p->v].trackActiveEntry();
+    }
+    return inc;
+  }
+
+  /// @see UniqueTable::decRef
+  [[nodiscard]] bool decRef(Node* p) noexcept {
+    const auto dec = ::dd::decRef(p);
+    if (dec && p->ref == 0U) {
+      --stats[p->v].numActiveEntries;
+      if (incremental) {
+        candidates.emplace_back(p);
+      }
+    }
+    return dec;
+  }
+
+  [[nodiscard]] bool possiblyNeedsCollection() const {
+    return getNumEntries() >= gcLimit;
+  }
+
+  /// @see UniqueTable::setIncrementalCollection
+  void setIncrementalCollection(const bool enable,
+                                const std::size_t sliceSize = 0U) {
+    incremental = enable;
+    gcSliceSize = sliceSize;
+    candidates.clear();
+    fullSweepPending = enable && getNumEntries() > 0U;
+  }
+
+  /// @see UniqueTable::getNumCollectionCandidates
+  [[nodiscard]] std::size_t getNumCollectionCandidates() const noexcept {
+    return candidates.size();
+  }
+
+  std::size_t garbageCollect(bool force = false) {
+    const std::size_t numEntriesBefore = getNumEntries();
+    if ((!force && numEntriesBefore < gcLimit) || numEntriesBefore == 0U) {
+      return 0U;
+    }
+
+    for (auto& stat : stats) {
+      ++stat.gcRuns;
+    }
+    if (incremental && !fullSweepPending) {
+      collectCandidates(force);
+    } else {
+      sweep();
+    }
+
+    // @see UniqueTable::garbageCollect
+    const auto numEntries = getNumEntries();
+    if (candidates.empty() && numEntries > gcLimit / 10 * 9) {
+      gcLimit = numEntries + initialGCLimit;
+    }
+    return numEntriesBefore - numEntries;
+  }
+
+  /**
+   * @brief Check whether the generation of a reclaimed node wrapped around
+   * @details Resets the flag. Compute table entries referencing nodes of this
+   * table cannot be validated via generations (see NodeGeneration) after a
+   * wrap-around and have to be cleared.
+   * @return whether a generation wrapped around since the last call
+   */
+  [[nodiscard]] bool consumeGenerationWrap() noexcept {
+    return std::exchange(generationWrapped, false);
+  }
+
+private:
+  /// @see UniqueTable::sweep
+  void sweep() {
+    candidates.clear();
+    fullSweepPending = false;
+    std::size_t v = 0U;
+    for (auto& table : tables) {
+      auto& stat = stats[v];
+      for (std::size_t b = 0U; b < table.size(); ++b) {
+        for (std::size_t s = 0U; s < SLOTS; ++s) {
+          Node* p = table[b].nodes[s];
+          if (p == nullptr || p->ref != 0) {
+            continue;
+          }
+          erase(table, b, s, hash(p));
+          reclaim(p);
+          --stat.numEntries;
+        }
+      }
+      stat.numActiveEntries = stat.numEntries;
+      ++v;
+    }
+  }
+
+  /// @see UniqueTable::collectCandidates
+  void collectCandidates(const bool all) {
+    std::sort(candidates.begin(), candidates.end(), std::less<Node*>{});
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    auto budget = candidates.size();
+    if (!all && gcSliceSize != 0U) {
+      budget = std::min(budget, gcSliceSize);
+    }
+    for (; budget > 0U; --budget) {
+      auto* p = candidates.back();
+      candidates.pop_back();
+      if (p->ref != 0U || p->v >= nvars) {
+        continue;
+      }
+      const auto v = p->v;
+      if (remove(p, hash(p))) {
+        reclaim(p);
+        --stats[v].numEntries;
+      }
+    }
+  }
+
+  /// Remove a node stored under the given key. Returns false if not found.
+  bool remove(const Node* p, const std::size_t key) {
+    auto& table = tables[p->v];
+    const auto mask = table.size() - 1U;
+    const auto tag = fingerprint(key);
+    auto b = key & mask;
+    for (std::size_t probes = 0U; probes < table.size(); ++probes) {
+      auto matches = matchTag(table[b].meta, tag);
+      while (matches != 0U) {
+        const auto s = lowestSlot(matches);
+        if (table[b].nodes[s] == p) {
+          erase(table, b, s, key);
+          return true;
+        }
+        matches &= matches - 1U;
+      }
+      if (overflowCount(table[b]) == 0U) {
+        return false;
+      }
+      b = (b + 1U) & mask;
+    }
+    return false;
+  }
+
+public:
+  void clear() {
+    for (auto& table : tables) {
+      std::fill(table.begin(), table.end(), Bucket{});
+    }
+    gcLimit = initialGCLimit;
+    candidates.clear();
+    fullSweepPending = false;
+    for (auto& stat : stats) {
+      stat.reset();
+    }
+  }
+
+  void print() {
+    auto q = nvars - 1U;
+    for (auto it = tables.rbegin(); it != tables.rend(); ++it) {
+      auto& table = *it;
+      std::cout << "\tq" << q << ":"
+                << "\n";
+      for (std::size_t key = 0; key < table.size(); ++key) {
+        const auto& bucket = table[key];
+        if (bucket.meta == 0U) {
+          continue;
+        }
+        std::cout << "\tkey=" << key << " (overflow "
+                  << static_cast<unsigned>(overflowCount(bucket)) << "):\n";
+        for (std::size_t s = 0U; s < SLOTS; ++s) {
+          const auto* p = bucket.nodes[s];
+          if (p == nullptr) {
+            continue;
+          }
+          std::cout << "\t\t" << std::hex << reinterpret_cast<std::uintptr_t>(p)
+                    << std::dec << " " << p->ref << std::hex;
+          for (const auto& e : p->e) {
+            std::cout << " p" << reinterpret_cast<std::uintptr_t>(e.p) << "(r"
+                      << reinterpret_cast<std::uintptr_t>(e.w.r) << " i"
+                      << reinterpret_cast<std::uintptr_t>(e.w.i) << ")";
+          }
+          std::cout << std::dec << "\n";
+        }
+      }
+      --q;
+    }
+  }
+
+  /**
+   * @brief Remove a node whose successors have changed from the table
+   * @details Counterpart of UniqueTable::alterUniqueTable. The node is
+   * afterwards re-inserted by a regular lookup.
+   * @param p The node to remove
+   * @param keyBefore The hash of the node before its successors were changed
+   */
+  void alterUniqueTable(Node* p, int keyBefore) {
+    const auto v = p->v;
+    if (remove(p, static_cast<std::size_t>(keyBefore))) {
+      --stats[v].numEntries;
+      // only moved within the table, see UniqueTable::alterUniqueTable
+      --stats[v].lookups;
+    }
+  }
+
+  /**
+   * @brief Remove all nodes of the given variable from the table and return
+   * them
+   * @details Counterpart of UniqueTable::getTableColumn. Every returned node
+   * forms a chain of length one (its `next` pointer is reset), so callers can
+   * walk the result exactly like the bucket heads of the chained table.
+   */
+  std::vector<Node*> getTableColumn(Qubit index) {
+    std::vector<Node*> res;
+    res.reserve(stats[index].numEntries);
+    for (auto& bucket : tables[index]) {
+      for (auto* p : bucket.nodes) {
+        if (p != nullptr) {
+          p->next = nullptr;
+          res.push_back(p);
+        }
+      }
+      bucket = Bucket{};
+    }
+    stats[index].numEntries = 0U;
+    return res;
+  }
+
+  /// @see UniqueTable::clearNextIndexTable
+  void clearNextIndexTable(Qubit index) {
+    std::fill(tables[index].begin(), tables[index].end(), Bucket{});
+    stats[index].numEntries = 0U;
+  }
+
+private:
+  static constexpr std::uint64_t LSB = 0x0101010101010101ULL;
+  static constexpr std::uint64_t LOW7 = 0x7F7F7F7F7F7F7F7FULL;
+  /// Mask of the fingerprint bytes (excluding the overflow counter)
+  static constexpr std::uint64_t TAG_BYTES = 0x00FFFFFFFFFFFFFFULL;
+  static constexpr std::size_t OVERFLOW_SHIFT = 56U;
+  static constexpr std::uint64_t OVERFLOW_MAX = 0xFFU;
+  /// Tables grow once they are filled beyond MAX_LOAD_NUM / MAX_LOAD_DEN
+  static constexpr std::size_t MAX_LOAD_NUM = 4U;
+  static constexpr std::size_t MAX_LOAD_DEN = 5U;
+
+  /// The number of variables
+  std::size_t nvars = 0U;
+  /// The actual tables (one for each variable)
+  std::vector<Table> tables;
+
+  /// A pointer to the memory manager for the nodes stored in the table.
+  MemoryManager<Node>* memoryManager;
+
+  /// Whether a generation counter wrapped around since the last check
+  bool generationWrapped = false;
+
+  /// @see UniqueTable::setIncrementalCollection
+  bool incremental = false;
+  std::size_t gcSliceSize = 0U;
+  std::vector<Node*> candidates{};
+  bool fullSweepPending = false;
+
+  /**
+   * @brief Return a collected node to the memory manager
+   * @details Bumps the node's generation so that compute table entries
+   * referencing it become stale. Since a node is collected at most once per
+   * garbage collection run, a wrap-around is always detected by the next
+   * consumeGenerationWrap() after the run.
+   */
+  void reclaim(Node* p) noexcept {
+    if (++p->generation == 0U) {
+      generationWrapped = true;
+    }
+    memoryManager->returnEntry(p);
+  }
+
+  /// A collection of statistics
+  std::vector<UniqueTableStatistics> stats{nvars};
+
+  /// The initial garbage collection limit
+  std::size_t initialGCLimit;
+  /// The current garbage collection limit
+  std::size_t gcLimit = initialGCLimit;
+
+  /// Fingerprint of a hash value (never zero, zero marks empty slots)
+  static constexpr std::uint8_t fingerprint(const std::size_t key) noexcept {
+    return static_cast<std::uint8_t>(0x80U | ((key >> 24U) & 0x7FU));
+  }
+
+  /**
+   * @brief Compare all fingerprints of a bucket against a given one
+   * @returns A mask with the high bit of every matching fingerprint byte set
+   */
+  static constexpr std::uint64_t matchTag(const std::uint64_t meta,
+                                          const std::uint8_t tag) noexcept {
+    const auto x = (meta ^ (LSB * tag)) & TAG_BYTES;
+    // exact zero-byte detection (no false positives from borrows)
+    const auto zero = ~(((x & LOW7) + LOW7) | x | LOW7);
+    return zero & TAG_BYTES;
+  }
+
+  /// Mask with the high bit of every empty slot byte set
+  static constexpr std::uint64_t emptySlots(const std::uint64_t meta) noexcept {
+    return matchTag(meta & TAG_BYTES, 0U);
+  }
+
+  static std::size_t lowestSlot(const std::uint64_t mask) noexcept {
+    std::size_t s = 0U;
+    while (((mask >> (8U * s + 7U)) & 1U) == 0U) {
+      ++s;
+    }
+    return s;
+  }
+
+  static constexpr std::uint64_t overflowCount(const Bucket& b) noexcept {
+    return b.meta >> OVERFLOW_SHIFT;
+  }
+
+  static void setTag(Bucket& b, const std::size_t s,
+                     const std::uint8_t tag) noexcept {
+    b.meta &= ~(0xFFULL << (8U * s));
+    b.meta |= static_cast<std::uint64_t>(tag) << (8U * s);
+  }
+
+  static void incOverflow(Bucket& b) noexcept {
+    if (overflowCount(b) != OVERFLOW_MAX) {
+      b.meta += 1ULL << OVERFLOW_SHIFT;
+    }
+  }
+
+  static void decOverflow(Bucket& b) noexcept {
+    // saturated counters stay conservative until the next rehash
+    if (const auto c = overflowCount(b); c != 0U && c != OVERFLOW_MAX) {
+      b.meta -= 1ULL << OVERFLOW_SHIFT;
+    }
+  }
+
+  /**
+   * @brief Search for a node equal to p
+   * @details Returns p to the memory manager if an equal node is found.
+   * @see UniqueTable::searchTable
+   */
+  Node* searchTable(Node* p, const std::size_t key) {
+    const auto v = p->v;
+    auto& table = tables[v];
+    const auto mask = table.size() - 1U;
+    const auto tag = fingerprint(key);
+    auto b = key & mask;
+    for (std::size_t probes = 0U; probes < table.size(); ++probes) {
+      const auto& bucket = table[b];
+      auto matches = matchTag(bucket.meta, tag);
+      while (matches != 0U) {
+        auto* candidate = bucket.nodes[lowestSlot(matches)];
+        if (nodesAreEqual(p, candidate)) {
+          if (p != candidate) {
+            memoryManager->returnEntry(p);
+          }
+          ++stats[v].hits;
+          return candidate;
+        }
+        ++stats[v].collisions;
+        matches &= matches - 1U;
+      }
+      if (overflowCount(bucket) == 0U) {
+        break;
+      }
+      ++stats[v].collisions;
+      b = (b + 1U) & mask;
+    }
+    return Node::getTerminal();
+  }
+
+  /// Insert a node into the first free slot along its probe sequence
+  static void insert(Table& table, Node* p, const std::size_t key) {
+    const auto mask = table.size() - 1U;
+    auto b = key & mask;
+    while (true) {
+      auto& bucket = table[b];
+      if (const auto empty = emptySlots(bucket.meta); empty != 0U) {
+        const auto s = lowestSlot(empty);
+        bucket.nodes[s] = p;
+        setTag(bucket, s, fingerprint(key));
+        return;
+      }
+      incOverflow(bucket);
+      b = (b + 1U) & mask;
+    }
+  }
+
+  /// Clear slot s of bucket b and undo the overflow accounting of its entry
+  static void erase(Table& table, const std::size_t b, const std::size_t s,
+                    const std::size_t key) {
+    const auto mask = table.size() - 1U;
+    table[b].nodes[s] = nullptr;
+    setTag(table[b], s, 0U);
+    for (auto h = key & mask; h != b; h = (h + 1U) & mask) {
+      decOverflow(table[h]);
+    }
+  }
+
+  /// Double the number of buckets of a variable and rehash its nodes
+  void grow(const std::size_t v) {
+    auto old = std::move(tables[v]);
+    tables[v] = Table(old.size() * 2U);
+    for (const auto& bucket : old) {
+      for (auto* p : bucket.nodes) {
+        if (p != nullptr) {
+          insert(tables[v], p, hash(p));
+        }
+      }
+    }
+    stats[v].numBuckets = tables[v].size();
+  }
+};
+
+} // namespace dd
@@ -0,0 +1,260 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Export.hpp"
+#include "dd/Package.hpp"
+#include "ir/Permutation.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace dd {
+
+/// The version of the checkpoint header (the DD itself is written with
+/// `serialize`, which has its own version)
+static constexpr std::uint64_t CHECKPOINT_VERSION = 1;
+
+/// When and where to write checkpoints of a long-running construction
+struct CheckpointConfig {
+  /// The file to write checkpoints to
+  std::string file;
+  /// Write a checkpoint after this many gates (0 disables this trigger)
+  std::size_t everyGates = 0U;
+  /// Write a checkpoint after this many seconds (0 disables this trigger)
+  double everySeconds = 0.;
+
+  [[nodiscard]] bool enabled() const noexcept {
+    return !file.empty() && (everyGates != 0U || everySeconds > 0.);
+  }
+};
+
+/// The state of a construction after the first `next` operations
+template <class Node> struct Checkpoint {
+  Edge<Node> state;
+  /// The index of the next operation to apply
+  std::size_t next = 0U;
+  /// The number of operations of the circuit
+  std::size_t circuitSize = 0U;
+  qc::Permutation permutation;
+};
+
+/**
+ * @brief Write a checkpoint in binary form
+ * @details The header holds the version, the radix of the nodes, the gate
+ * indices and the permutation. It is followed by the binary serialization of
+ * the DD (see serialize).
+ */
+template <class Node>
+void writeCheckpoint(std::ostream& os, const Edge<Node>& state,
+                     const std::size_t next, const std::size_t circuitSize,
+                     const qc::Permutation& permutation) {
+  const auto write = [&os](const std::uint64_t value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  write(CHECKPOINT_VERSION);
+  write(std::tuple_size_v<decltype(Node::e)>);
+  write(next);
+  write(circuitSize);
+  write(permutation.size());
+  for (const auto& [from, to] : permutation) {
+    os.write(reinterpret_cast<const char*>(&from), sizeof(from));
+    os.write(reinterpret_cast<const char*>(&to), sizeof(to));
+  }
+  serialize(state, os, true);
+}
+
+/**
+ * @brief Write a checkpoint to a file
+ * @details The checkpoint is written to a temporary file that then replaces
+ * `file`, so a crash while writing leaves the previous checkpoint intact.
+ */
+template <class Node>
+void writeCheckpoint(const std::string& file, const Edge<Node>& state,
+                     const std::size_t next, const std::size_t circuitSize,
+                     const qc::Permutation& permutation) {
+  const auto tmp = file + ".tmp";
+  {
+    std::ofstream ofs(tmp, std::ios::binary);
+    if (!ofs.good()) {
+      throw std::invalid_argument("Cannot open file: " + tmp);
+    }
+    writeCheckpoint(ofs, state, next, circuitSize, permutation);
+    if (!ofs.good()) {
+      throw std::runtime_error("Could not write checkpoint " + tmp);
+    }
+  }
+  std::filesystem::rename(tmp, file);
+}
+
+/**
+ * @brief Read a checkpoint into a package
+ * @return The checkpoint (its state is referenced)
+ */
+template <class Node, class Config>
+Checkpoint<Node> readCheckpoint(std::istream& is, Package<Config>& dd) {
+  const auto read = [&is]() {
+    std::uint64_t value{};
+    is.read(reinterpret_cast<char*>(&value), sizeof(value));
+    if (!is.good()) {
+      throw std::runtime_error("Unexpected end of checkpoint.");
+    }
+    return value;
+  };
+  if (const auto version = read(); version != CHECKPOINT_VERSION) {
+    throw std::runtime_error(
+        "Wrong version of checkpoint file. version of file: " +
+        std::to_string(version) +
+        "; current version: " + std::to_string(CHECKPOINT_VERSION));
+  }
+  if (read() != std::tuple_size_v<decltype(Node::e)>) {
+    throw std::runtime_error("Checkpoint holds a different kind of DD.");
+  }
+  Checkpoint<Node> checkpoint{};
+  checkpoint.next = static_cast<std::size_t>(read());
+  checkpoint.circuitSize = static_cast<std::size_t>(read());
+  const auto size = read();
+  for (std::uint64_t i = 0U; i < size; ++i) {
+    qc::Qubit from{};
+    qc::Qubit to{};
+    is.read(reinterpret_cast<char*>(&from), sizeof(from));
+    is.read(reinterpret_cast<char*>(&to), sizeof(to));
+    checkpoint.permutation[from] = to;
+  }
+  if (!is.good()) {
+    throw std::runtime_error("Unexpected end of checkpoint.");
+  }
+  checkpoint.state = dd.template deserialize<Node>(is, true);
+  dd.incRef(checkpoint.state);
+  return checkpoint;
+}
+
+template <class Node, class Config>
+Checkpoint<Node> readCheckpoint(const std::string& file, Package<Config>& dd) {
+  std::ifstream ifs(file, std::ios::binary);
+  if (!ifs.good()) {
+    throw std::invalid_argument("Cannot open checkpoint file: " + file);
+  }
+  return readCheckpoint<Node>(ifs, dd);
+}
+
+/**
+ * @brief Periodically writes checkpoints of a construction in the background
+ * @details When a checkpoint is due, the current DD is referenced once more.
+ * This snapshot keeps garbage collection from freeing its nodes and weights,
+ * which never change while they are alive. Thus, a background thread can
+ * serialize it while the main loop keeps going. The snapshot is released by
+ * the main loop once the write has finished, since the package is not
+ * thread-safe. If a checkpoint is due while the previous one is still being
+ * written, it is postponed until after a later gate.
+ */
+template <class Config, class Node> class Checkpointer {
+public:
+  Checkpointer(Package<Config>& package, CheckpointConfig checkpointConfig,
+               const std::size_t size)
+      : dd(package), config(std::move(checkpointConfig)), circuitSize(size),
+        last(std::chrono::steady_clock::now()) {}
+
+  Checkpointer(const Checkpointer&) = delete;
+  Checkpointer& operator=(const Checkpointer&) = delete;
+
+  ~Checkpointer() {
+    if (pending.valid()) {
+      pending.wait();
+    }
+    release();
+  }
+
+  /**
+   * @brief Write a checkpoint if one is due
+   * @param state The current DD
+   * @param next The index of the next operation to apply
+   * @param permutation The current permutation
+   */
+  void step(const Edge<Node>& state, const std::size_t next,
+            const qc::Permutation& permutation) {
+    if (!config.enabled()) {
+      return;
+    }
+    ++gatesSinceLast;
+    const auto now = std::chrono::steady_clock::now();
+    const auto due =
+        (config.everyGates != 0U && gatesSinceLast >= config.everyGates) ||
+        (config.everySeconds > 0. &&
+         std::chrono::duration<double>(now - last).count() >=
+             config.everySeconds);
+    if (!due) {
+      return;
+    }
+    if (pending.valid()) {
+      if (pending.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready) {
+        return;
+      }
+      collect();
+    }
+
+    snapshot = state;
+    dd.incRef(snapshot);
+    hasSnapshot = true;
+    gatesSinceLast = 0U;
+    last = now;
+    pending = std::async(std::launch::async,
+                         [file = config.file, e = snapshot, next,
+                          size = circuitSize, permutation]() {
+                           writeCheckpoint(file, e, next, size, permutation);
+                         });
+  }
+
+  /// Wait for the pending checkpoint (rethrowing its errors)
+  void finish() {
+    if (pending.valid()) {
+      collect();
+    }
+  }
+
+  /// The number of checkpoints that have been written completely
+  [[nodiscard]] std::size_t written() const noexcept { return count; }
+
+private:
+  void collect() {
+    // release the snapshot even if writing it failed
+    try {
+      pending.get();
+    } catch (...) {
+      release();
+      throw;
+    }
+    release();
+    ++count;
+  }
+
+  void release() noexcept {
+    if (hasSnapshot) {
+      dd.decRef(snapshot);
+      hasSnapshot = false;
+    }
+  }
+
+  Package<Config>& dd;
+  CheckpointConfig config;
+  std::size_t circuitSize;
+  std::future<void> pending;
+  Edge<Node> snapshot{};
+  bool hasSnapshot = false;
+  std::size_t gatesSinceLast = 0U;
+  std::chrono::steady_clock::time_point last;
+  std::size_t count = 0U;
+};
+
+} // namespace dd
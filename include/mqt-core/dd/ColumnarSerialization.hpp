@@ -0,0 +1,164 @@
+#pragma once
+
+#include "dd/CachedEdge.hpp"
+#include "dd/ComplexValue.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Node.hpp"
+#include "dd/Package.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace dd {
+
+///
+/// Columnar serialization
+/// A file consists of a fixed-size header followed by four columns, each
+/// padded to a multiple of 8 bytes:
+///   - the weight pool: every distinct edge weight once, as (real, imag)
+///   - the successors: RADIX/NEDGE 32-bit node indices per node
+///   - the edge weights: RADIX/NEDGE 32-bit weight pool indices per node
+///   - the levels: one Qubit per node
+/// Nodes are sorted by level in ascending order, so every successor precedes
+/// its parent and a file can be loaded with a single bottom-up pass.
+/// Note: the format uses the native byte order and is not portable across
+/// architectures/platforms
+///
+
+static constexpr std::uint32_t COLUMNAR_VERSION = 1;
+
+/// A validated, read-only view of a serialized DD (see serializeColumnar)
+struct ColumnarView {
+  /// Successor index of terminal edges
+  static constexpr auto TERMINAL = std::numeric_limits<std::uint32_t>::max();
+
+  /// The number of successors per node
+  std::uint32_t radix = 0U;
+  std::uint64_t numNodes = 0U;
+  std::uint64_t numWeights = 0U;
+  /// The node the root edge points to (or TERMINAL)
+  std::uint32_t root = TERMINAL;
+  /// The weight of the root edge
+  std::uint32_t rootWeight = 0U;
+  /// 2 * numWeights entries
+  const fp* weights = nullptr;
+  /// radix * numNodes entries
+  const std::uint32_t* successors = nullptr;
+  /// radix * numNodes entries
+  const std::uint32_t* edgeWeights = nullptr;
+  /// numNodes entries
+  const Qubit* levels = nullptr;
+};
+
+/**
+ * @brief Parse and validate a serialized DD
+ * @details Checks the version and that all indices are in range and point
+ * to nodes on lower levels that precede the referencing node.
+ * @param data The serialized DD (8-byte aligned)
+ * @param size The size of the serialized DD in bytes
+ * @throws std::runtime_error if the data is not a valid serialized DD
+ */
+ColumnarView parseColumnar(const char* data, std::size_t size);
+
+/**
+ * @brief A read-only mapping of a whole file
+ * @details Falls back to reading the file into memory on platforms without
+ * `mmap`.
+ */
+class MappedFile {
+public:
+  /// @throws std::invalid_argument if the file cannot be opened
+  explicit MappedFile(const std::string& file);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+
+  [[nodiscard]] const char* data() const noexcept { return begin; }
+  [[nodiscard]] std::size_t size() const noexcept { return length; }
+
+private:
+  const char* begin = nullptr;
+  std::size_t length = 0U;
+  bool mapped = false;
+  std::vector<char> buffer;
+};
+
+/// Write a DD in the columnar format
+void serializeColumnar(const vEdge& root, std::ostream& os);
+/// @see serializeColumnar
+void serializeColumnar(const mEdge& root, std::ostream& os);
+
+template <class Node>
+void serializeColumnar(const Edge<Node>& root, const std::string& file) {
+  std::ofstream ofs(file, std::ios::binary);
+  if (!ofs.good()) {
+    throw std::invalid_argument("Cannot open file: " + file);
+  }
+  serializeColumnar(root, ofs);
+}
+
+/**
+ * @brief Load a DD in the columnar format into a package
+ * @details The nodes are inserted into the unique table in file order, i.e.,
+ * bottom-up, with their successors taken from the already inserted nodes by
+ * index. Like in deserialize, the weights are only looked up once a node has
+ * been normalized.
+ * @return The DD (not referenced)
+ */
+template <class Node, class Config>
+Edge<Node> deserializeColumnar(const char* data, const std::size_t size,
+                               Package<Config>& dd) {
+  static_assert(std::is_same_v<Node, vNode> || std::is_same_v<Node, mNode>,
+                "Only vector and matrix DDs can be deserialized.");
+  constexpr auto N = std::tuple_size_v<decltype(Node::e)>;
+  const auto view = parseColumnar(data, size);
+  if (view.radix != N) {
+    throw std::runtime_error("Serialized DD is of a different kind.");
+  }
+
+  // the weight of a created node is one unless normalization differs by
+  // rounding, in which case it is pushed into the referencing edges
+  std::vector<CachedEdge<Node>> nodes(view.numNodes);
+  const auto edgeTo = [&](const std::uint32_t successor,
+                          const std::uint32_t weight) {
+    const ComplexValue w{view.weights[2U * weight],
+                         view.weights[(2U * weight) + 1U]};
+    if (successor == ColumnarView::TERMINAL) {
+      return CachedEdge<Node>::terminal(w);
+    }
+    const auto& node = nodes[successor];
+    return CachedEdge<Node>{node.p, node.w.exactlyOne() ? w : w * node.w};
+  };
+
+  std::array<CachedEdge<Node>, N> edges{};
+  for (std::size_t i = 0U; i < nodes.size(); ++i) {
+    for (std::size_t j = 0U; j < N; ++j) {
+      edges[j] = edgeTo(view.successors[(i * N) + j],
+                        view.edgeWeights[(i * N) + j]);
+    }
+    nodes[i] = dd.makeDDNode(view.levels[i], edges);
+  }
+  const auto root = edgeTo(view.root, view.rootWeight);
+  return {root.p, dd.cn.lookup(root.w)};
+}
+
+/// Load a DD in the columnar format from a file via a single `mmap`
+template <class Node, class Config>
+Edge<Node> deserializeColumnar(const std::string& file, Package<Config>& dd) {
+  const MappedFile mapped(file);
+  return deserializeColumnar<Node>(mapped.data(), mapped.size(), dd);
+}
+
+} // namespace dd
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "dd/DDDefinitions.hpp"
+#include "dd/Edge.hpp"
+#include "dd/Node.hpp"
+#include "dd/Package.hpp"
+#include "dd/RealNumber.hpp"
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace dd {
+
+/**
+ * @brief A compact, index-based representation of a vector or matrix DD
+ * @details The live DD package links nodes through 64-bit pointers and stores
+ * edge weights as pairs of pointers into the real number table, which amounts
+ * to more than 100 bytes per matrix node. A CompactDD stores the nodes of a
+ * single DD in one contiguous array. Successors are referenced by 32-bit node
+ * indices and edge weights by 32-bit indices into a deduplicated pool of real
+ * numbers, which halves the footprint of a node (52 instead of 112 bytes for
+ * a matrix node and 28 instead of 64 bytes for a vector node). Nodes are
+ * stored in post-order, i.e., every node is preceded by its successors and
+ * the root is the last node.
+ *
+ * The representation is immutable. It is meant for keeping large DDs around
+ * (e.g., intermediate results) and traversing them cache-efficiently without
+ * occupying the unique tables of a package. It can be converted back into a
+ * regular DD of any package via toEdge().
+ *
+ * Note: the nodes of a package are not stored this way. Operations on DDs
+ * (multiplication, addition, reordering, ...) always work on pointer-based
+ * nodes, so a CompactDD has to be converted back before it is used in them.
+ * @tparam Node The node type (vNode or mNode)
+ */
+template <class Node> class CompactDD {
+  static_assert(std::is_same_v<Node, vNode> || std::is_same_v<Node, mNode>,
+                "CompactDD supports vector and matrix DDs only");
+
+public:
+  using Index = std::uint32_t;
+  /// Node index used for the terminal node
+  static constexpr Index TERMINAL = std::numeric_limits<Index>::max();
+  /// Indices of the real numbers zero and one in the pool
+  static constexpr Index ZERO = 0U;
+  static constexpr Index ONE = 1U;
+
+  static constexpr std::size_t NEDGES = std::tuple_size_v<decltype(Node::e)>;
+
+  /// An edge referencing its successor and weight by index (12 bytes)
+  struct CEdge {
+    Index p = TERMINAL;
+    Index r = ZERO;
+    Index i = ZERO;
+
+    [[nodiscard]] bool isTerminal() const noexcept { return p == TERMINAL; }
+    [[nodiscard]] bool isZero() const noexcept {
+      return isTerminal() && r == ZERO && i == ZERO;
+    }
+  };
+
+  struct CNode {
+    std::array<CEdge, NEDGES> e{};
+    Qubit v{};
+  };
+
+  CompactDD() = default;
+
+  /**
+   * @brief Create the compact representation of a DD
+   * @param e the root edge of the DD
+   * @throws std::overflow_error if the DD has more than 2^32-1 nodes or
+   * distinct weight components
+   */
+  explicit CompactDD(const Edge<Node>& e) {
+    reals = {0., 1.};
+    realIndex = {{0., ZERO}, {1., ONE}};
+    std::unordered_map<const Node*, Index> visited{};
+    root = convert(e, visited);
+    realIndex.clear();
+  }
+
+  [[nodiscard]] const CEdge& getRoot() const noexcept { return root; }
+  [[nodiscard]] const std::vector<CNode>& getNodes() const noexcept {
+    return nodes;
+  }
+  [[nodiscard]] const std::vector<fp>& getReals() const noexcept {
+    return reals;
+  }
+
+  /// Number of nodes (including the terminal), consistent with Edge::size()
+  [[nodiscard]] std::size_t size() const noexcept { return nodes.size() + 1U; }
+
+  /// Memory occupied by the nodes and the real number pool in bytes
+  [[nodiscard]] std::size_t memoryBytes() const noexcept {
+    return sizeof(CNode) * nodes.size() + sizeof(fp) * reals.size();
+  }
+
+  [[nodiscard]] std::complex<fp> weight(const CEdge& e) const {
+    return {reals[e.r], reals[e.i]};
+  }
+
+  /**
+   * @brief Get a single amplitude of a vector DD
+   * @param i the index of the amplitude
+   */
+  template <typename T = Node, isVector<T> = true>
+  [[nodiscard]] std::complex<fp> getValueByIndex(const std::size_t i) const {
+    auto c = weight(root);
+    auto e = root;
+    while (!e.isTerminal() && c != 0.) {
+      const auto& n = nodes[e.p];
+      e = n.e[(i >> n.v) & 1U];
+      c *= weight(e);
+    }
+    return c;
+  }
+
+  /**
+   * @brief Get a single entry of a matrix DD
+   * @details Levels that have been skipped because they resemble the identity
+   * contribute a factor of one on the diagonal and zero elsewhere.
+   * @param numQubits the number of qubits the matrix acts on
+   * @param i the row index
+   * @param j the column index
+   */
+  template <typename T = Node, isMatrixVariant<T> = true>
+  [[nodiscard]] std::complex<fp> getValueByIndex(const std::size_t numQubits,
+                                                 const std::size_t i,
+                                                 const std::size_t j) const {
+    auto c = weight(root);
+    auto e = root;
+    auto level = static_cast<std::int64_t>(numQubits) - 1;
+    while (c != 0.) {
+      const auto next =
+          e.isTerminal() ? -1 : static_cast<std::int64_t>(nodes[e.p].v);
+      for (; level > next; --level) {
+        if (((i >> level) & 1U) != ((j >> level) & 1U)) {
+          return 0.;
+        }
+      }
+      if (e.isTerminal()) {
+        break;
+      }
+      const auto& n = nodes[e.p];
+      e = n.e[(((i >> n.v) & 1U) << 1U) | ((j >> n.v) & 1U)];
+      c *= weight(e);
+      --level;
+    }
+    return c;
+  }
+
+  /**
+   * @brief Rebuild the DD in a package
+   * @param pkg the package to create the DD in
+   * @return the root edge of the rebuilt DD (not reference counted)
+   */
+  template <class Config>
+  [[nodiscard]] Edge<Node> toEdge(Package<Config>& pkg) const {
+    std::vector<Edge<Node>> rebuilt{};
+    rebuilt.reserve(nodes.size());
+    const auto materialize = [&](const CEdge& ce) {
+      if (ce.isTerminal()) {
+        return Edge<Node>::terminal(pkg.cn.lookup(weight(ce)));
+      }
+      const auto& succ = rebuilt[ce.p];
+      return Edge<Node>{succ.p, pkg.cn.lookup(weight(ce) *
+                                              static_cast<std::complex<fp>>(
+                                                  succ.w))};
+    };
+    for (const auto& n : nodes) {
+      std::array<Edge<Node>, NEDGES> edges{};
+      for (std::size_t k = 0U; k < NEDGES; ++k) {
+        edges[k] = materialize(n.e[k]);
+      }
+      rebuilt.emplace_back(pkg.makeDDNode(n.v, edges));
+    }
+    return materialize(root);
+  }
+
+private:
+  CEdge root{};
+  std::vector<CNode> nodes{};
+  std::vector<fp> reals{};
+  std::unordered_map<fp, Index> realIndex{};
+
+  Index internReal(const fp value) {
+    const auto [it, inserted] =
+        realIndex.try_emplace(value, static_cast<Index>(reals.size()));
+    if (inserted) {
+      if (reals.size() >= TERMINAL) {
+        throw std::overflow_error("Too many distinct weights for CompactDD");
+      }
+      reals.emplace_back(value);
+    }
+    return it->second;
+  }
+
+  CEdge convert(const Edge<Node>& e,
+                std::unordered_map<const Node*, Index>& visited) {
+    CEdge ce{};
+    ce.r = internReal(RealNumber::val(e.w.r));
+    ce.i = internReal(RealNumber::val(e.w.i));
+    if (e.isTerminal()) {
+      return ce;
+    }
+    if (const auto it = visited.find(e.p); it != visited.end()) {
+      ce.p = it->second;
+      return ce;
+    }
+    CNode n{};
+    n.v = e.p->v;
+    for (std::size_t k = 0U; k < NEDGES; ++k) {
+      n.e[k] = convert(e.p->e[k], visited);
+    }
+    if (nodes.size() >= TERMINAL) {
+      throw std::overflow_error("Too many nodes for CompactDD");
+    }
+    ce.p = static_cast<Index>(nodes.size());
+    nodes.emplace_back(n);
+    visited.emplace(e.p, ce.p);
+    return ce;
+  }
+};
+
+using CompactVectorDD = CompactDD<vNode>;
+using CompactMatrixDD = CompactDD<mNode>;
+
+} // namespace dd
@@ -7,6 +7,7 @@
 #include <array>
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 
@@ -17,9 +18,21 @@ namespace dd {
 /// \tparam RightOperandType type of the operation's right operand
 /// \tparam ResultType type of the operation's result
 /// \tparam NBUCKET number of hash buckets to use (has to be a power of two)
+/// \tparam NWAYS associativity of the table (1, 2 or 4). With NWAYS == 1 the
+/// table is direct-mapped. Otherwise, the NBUCKET entries are grouped into sets
+/// of NWAYS entries, a lookup checks all entries of a set and an insert into
+/// a full set evicts its least recently used entry.
+/// \note If all operand and result types reference vector or matrix nodes,
+/// entries record the generations of these nodes and are treated as misses
+/// once a referenced node has been reclaimed (see NodeGeneration).
 template <class LeftOperandType, class RightOperandType, class ResultType,
-          std::size_t NBUCKET = 16384>
+          std::size_t NBUCKET = 16384, std::size_t NWAYS = 1>
 class ComputeTable {
+  static_assert(NWAYS == 1 || NWAYS == 2 || NWAYS == 4,
+                "Only 1-, 2- and 4-way tables are supported");
+  static_assert(NBUCKET % NWAYS == 0,
+                "NBUCKET must be a multiple of the associativity");
+
 public:
   ComputeTable() {
     stats.entrySize = sizeof(Entry);
@@ -30,9 +43,20 @@ public:
     LeftOperandType leftOperand;
     RightOperandType rightOperand;
     ResultType result;
+    std::uint8_t leftGeneration;
+    std::uint8_t rightGeneration;
+    std::uint8_t resultGeneration;
   };
 
-  static constexpr std::size_t MASK = NBUCKET - 1;
+  /// Whether entries are validated against the generations of their nodes
+  static constexpr bool TRACKS_GENERATIONS =
+      NodeGeneration<LeftOperandType>::TRACKED &&
+      NodeGeneration<RightOperandType>::TRACKED &&
+      NodeGeneration<ResultType>::TRACKED;
+
+  /// The number of sets (equals NBUCKET for direct-mapped tables)
+  static constexpr std::size_t NSETS = NBUCKET / NWAYS;
+  static constexpr std::size_t MASK = NSETS - 1;
 
   static std::size_t hash(const LeftOperandType& leftOperand,
                           const RightOperandType& rightOperand) {
@@ -63,13 +87,49 @@ public:
   void insert(const LeftOperandType& leftOperand,
               const RightOperandType& rightOperand, const ResultType& result) {
     const auto key = hash(leftOperand, rightOperand);
-    if (valid[key]) {
-      ++stats.collisions;
+    if constexpr (NWAYS == 1) {
+      if (valid[key]) {
+        ++stats.collisions;
+      } else {
+        stats.trackInsert();
+        valid.set(key);
+      }
+      table[key] = makeEntry(leftOperand, rightOperand, result);
     } else {
-      stats.trackInsert();
-      valid.set(key);
+      const auto base = key * NWAYS;
+      std::size_t way = NWAYS;
+      // an entry for the same operands (tag match) is simply updated
+      for (std::size_t w = 0U; w < NWAYS; ++w) {
+        if (valid[base + w] && table[base + w].leftOperand == leftOperand &&
+            table[base + w].rightOperand == rightOperand) {
+          way = w;
+          break;
+        }
+      }
+      if (way == NWAYS) {
+        // otherwise, use a free way or evict the least recently used one
+        way = 0U;
+        for (std::size_t w = 0U; w < NWAYS; ++w) {
+          if (!valid[base + w]) {
+            way = w;
+            break;
+          }
+          if (age[base + w] > age[base + way]) {
+            way = w;
+          }
+        }
+        if (valid[base + way]) {
+          ++stats.collisions;
+        } else {
+          stats.trackInsert();
+          valid.set(base + way);
+          // a fresh entry starts out as the oldest one of the set
+          age[base + way] = static_cast<std::uint8_t>(NWAYS - 1U);
+        }
+      }
+      table[base + way] = makeEntry(leftOperand, rightOperand, result);
+      touch(base, way);
     }
-    table[key] = {leftOperand, rightOperand, result};
   }
 
   ResultType* lookup(const LeftOperandType& leftOperand,
@@ -78,31 +138,46 @@ public:
     ResultType* result = nullptr;
     ++stats.lookups;
     const auto key = hash(leftOperand, rightOperand);
-    if (!valid[key]) {
-      return result;
-    }
+    const auto base = key * NWAYS;
+    for (std::size_t w = 0U; w < NWAYS; ++w) {
+      if (!valid[base + w]) {
+        continue;
+      }
 
-    auto& entry = table[key];
-    if (entry.leftOperand != leftOperand) {
-      return result;
-    }
-    if (entry.rightOperand != rightOperand) {
-      return result;
-    }
+      auto& entry = table[base + w];
+      if (entry.leftOperand != leftOperand) {
+        continue;
+      }
+      if (entry.rightOperand != rightOperand) {
+        continue;
+      }
 
-    if constexpr (std::is_same_v<RightOperandType, dNode*> ||
-                  std::is_same_v<RightOperandType, dCachedEdge>) {
-      // Since density matrices are reduced representations of matrices, a
-      // density matrix may not be returned when a matrix is required and vice
-      // versa
-      if (!dNode::isTerminal(entry.result.p) &&
-          dNode::isDensityMatrixNode(entry.result.p->flags) !=
-              useDensityMatrix) {
-        return result;
+      if constexpr (std::is_same_v<RightOperandType, dNode*> ||
+                    std::is_same_v<RightOperandType, dCachedEdge>) {
+        // Since density matrices are reduced representations of matrices, a
+        // density matrix may not be returned when a matrix is required and
+        // vice versa
+        if (!dNode::isTerminal(entry.result.p) &&
+            dNode::isDensityMatrixNode(entry.result.p->flags) !=
+                useDensityMatrix) {
+          return result;
+        }
       }
+      if constexpr (TRACKS_GENERATIONS) {
+        // a referenced node has been reclaimed since the entry was inserted
+        if (isStale(entry)) {
+          valid.reset(base + w);
+          --stats.numEntries;
+          return result;
+        }
+      }
+      if constexpr (NWAYS > 1) {
+        touch(base, w);
+      }
+      ++stats.hits;
+      return &entry.result;
     }
-    ++stats.hits;
-    return &entry.result;
+    return result;
   }
 
   void clear() {
@@ -110,6 +185,9 @@ public:
     stats.reset();
   }
 
+  /// @see TableStatistics::checkpoint
+  void checkpointStatistics() noexcept { stats.checkpoint(); }
+
   std::ostream& printStatistics(std::ostream& os = std::cout) {
     return os << stats;
   }
@@ -117,6 +195,40 @@ public:
 private:
   std::array<Entry, NBUCKET> table{};
   std::bitset<NBUCKET> valid{};
+  /// Age of each entry within its set (0 = most recently used)
+  std::array<std::uint8_t, NWAYS == 1 ? 1 : NBUCKET> age{};
   TableStatistics stats{};
+
+  static Entry makeEntry(const LeftOperandType& leftOperand,
+                         const RightOperandType& rightOperand,
+                         const ResultType& result) noexcept {
+    return {leftOperand,
+            rightOperand,
+            result,
+            NodeGeneration<LeftOperandType>::of(leftOperand),
+            NodeGeneration<RightOperandType>::of(rightOperand),
+            NodeGeneration<ResultType>::of(result)};
+  }
+
+  static bool isStale(const Entry& entry) noexcept {
+    return entry.leftGeneration !=
+               NodeGeneration<LeftOperandType>::of(entry.leftOperand) ||
+           entry.rightGeneration !=
+               NodeGeneration<RightOperandType>::of(entry.rightOperand) ||
+           entry.resultGeneration !=
+               NodeGeneration<ResultType>::of(entry.result);
+  }
+
+  /// Mark an entry as most recently used and age all younger entries of its
+  /// set. The ages of a set thus always form a permutation of 0..NWAYS-1.
+  void touch(const std::size_t base, const std::size_t way) noexcept {
+    const auto current = age[base + way];
+    for (std::size_t w = 0U; w < NWAYS; ++w) {
+      if (age[base + w] < current) {
+        ++age[base + w];
+      }
+    }
+    age[base + way] = 0U;
+  }
 };
 } // namespace dd
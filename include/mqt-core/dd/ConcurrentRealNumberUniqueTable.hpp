@@ -0,0 +1,159 @@
+#pragma once
+
+#include "dd/DDDefinitions.hpp"
+#include "dd/MemoryManager.hpp"
+#include "dd/statistics/UniqueTableStatistics.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace dd {
+
+struct RealNumber;
+
+/**
+ * @brief A unique table for real numbers that supports concurrent lookups.
+ * @details The table uses the same (clipped linear) hash function and the same
+ * tolerance semantics as the RealNumberUniqueTable, so that numbers within
+ * RealNumber::eps of each other are mapped to the same entry. In contrast to
+ * the sequential table, it can be shared among threads:
+ *  - Buckets are unsorted singly linked lists with an atomic head. Entries are
+ *    immutable once published, so looking up an existing value is a lock-free
+ *    read of at most two buckets.
+ *  - New entries are prepended to their bucket with a compare-and-swap on the
+ *    bucket head. If the swap fails, the entries inserted in the meantime are
+ *    checked for a match before retrying.
+ *  - A value whose tolerance interval crosses a bucket border may match
+ *    entries in the neighbouring bucket. Such (rare) insertions are serialized
+ *    by a striped lock per border so that two threads cannot insert matching
+ *    values on both sides of the same border.
+ *  - Allocating entries from the memory manager is guarded by a mutex.
+ *
+ * Reclamation is deferred: reference counting and garbage collection are not
+ * synchronized and must only happen in quiescent phases, i.e., while no other
+ * thread accesses the table. Entries created concurrently start with a
+ * reference count of zero and stay valid until the next such phase.
+ */
+class ConcurrentRealNumberUniqueTable {
+public:
+  /// @see RealNumberUniqueTable::NBUCKET
+  static constexpr std::size_t NBUCKET = 65537U;
+  /// @see RealNumberUniqueTable::INITIAL_GC_LIMIT
+  static constexpr std::size_t INITIAL_GC_LIMIT = 65536U;
+  /// The number of locks guarding insertions at bucket borders
+  static constexpr std::size_t NBORDERLOCKS = 64U;
+
+  /**
+   * @brief The default constructor
+   * @param manager The memory manager to use for allocating new numbers.
+   * @param initialGCLim The initial garbage collection limit.
+   */
+  explicit ConcurrentRealNumberUniqueTable(
+      MemoryManager<RealNumber>& manager,
+      std::size_t initialGCLim = INITIAL_GC_LIMIT);
+
+  /// @see RealNumberUniqueTable::hash
+  static std::int64_t hash(fp val) noexcept;
+
+  /**
+   * @brief Lookup a number in the table and insert it if it is not present.
+   * @details Safe to call concurrently from multiple threads.
+   * @param val The floating point number to look up.
+   * @return A pointer to an entry corresponding to that number.
+   * @see RealNumberUniqueTable::lookup
+   */
+  [[nodiscard]] RealNumber* lookup(fp val);
+
+  /**
+   * @brief Increment the reference count of a number.
+   * @note Must only be called in quiescent phases.
+   * @see RealNumberUniqueTable::incRef
+   */
+  void incRef(RealNumber* num) noexcept;
+
+  /**
+   * @brief Decrement the reference count of a number.
+   * @note Must only be called in quiescent phases.
+   * @see RealNumberUniqueTable::decRef
+   */
+  void decRef(RealNumber* num) noexcept;
+
+  /// Get the number of entries in the table
+  [[nodiscard]] std::size_t getNumEntries() const noexcept {
+    return numEntries.load(std::memory_order_relaxed);
+  }
+
+  /// Get a snapshot of the statistics
+  [[nodiscard]] UniqueTableStatistics getStats() const noexcept;
+
+  /// @see RealNumberUniqueTable::possiblyNeedsCollection
+  [[nodiscard]] bool possiblyNeedsCollection() const noexcept;
+
+  /**
+   * @brief Perform garbage collection.
+   * @note Must only be called in quiescent phases.
+   * @see RealNumberUniqueTable::garbageCollect
+   */
+  std::size_t garbageCollect(bool force = false) noexcept;
+
+  /**
+   * @brief Clear the table.
+   * @note Must only be called in quiescent phases.
+   */
+  void clear() noexcept;
+
+private:
+  using Bucket = std::atomic<RealNumber*>;
+
+  std::array<Bucket, NBUCKET> table{};
+  std::array<std::mutex, NBORDERLOCKS> borderLocks{};
+
+  /// A pointer to the memory manager for the numbers stored in the table.
+  MemoryManager<RealNumber>* memoryManager{};
+  /// Guards the memory manager
+  std::mutex memoryMutex;
+
+  std::atomic<std::size_t> numEntries{0U};
+  std::atomic<std::size_t> peakNumEntries{0U};
+  std::atomic<std::size_t> lookups{0U};
+  std::atomic<std::size_t> hits{0U};
+  std::atomic<std::size_t> collisions{0U};
+  std::atomic<std::size_t> inserts{0U};
+  std::size_t numActiveEntries = 0U;
+  std::size_t peakNumActiveEntries = 0U;
+  std::size_t gcRuns = 0U;
+
+  /// The initial garbage collection limit
+  std::size_t initialGCLimit;
+  /// The current garbage collection limit
+  std::size_t gcLimit = initialGCLimit;
+
+  /// Lookup a non-negative number (@see RealNumberUniqueTable)
+  [[nodiscard]] RealNumber* lookupNonNegative(fp val);
+
+  /**
+   * @brief Find a value in the buckets [lowerKey, upperKey] or insert it into
+   * the bucket indexed by key.
+   * @returns A pointer to the closest entry within tolerance or the newly
+   * inserted entry.
+   */
+  RealNumber* findOrInsert(std::int64_t key, std::int64_t lowerKey,
+                           std::int64_t upperKey, fp val);
+
+  /**
+   * @brief Find the entry closest to val within tolerance in a bucket list.
+   * @param head The first entry to inspect.
+   * @param stop The entry at which to stop (exclusive).
+   * @param val The value to look for.
+   * @param best The closest entry found so far (updated in place).
+   */
+  void findClosest(RealNumber* head, const RealNumber* stop, fp val,
+                   RealNumber*& best) noexcept;
+
+  RealNumber* allocate(fp val);
+  void release(RealNumber* entry);
+};
+} // namespace dd
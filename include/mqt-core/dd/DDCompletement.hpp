@@ -20,7 +20,7 @@
 
 namespace dd {
 
-    void checkRefValue(MatrixDD root)
+    inline void checkRefValue(MatrixDD root)
     {
         std::queue<MatrixDD> que;
         if(root.isTerminal())
@@ -57,7 +57,7 @@ namespace dd {
     /**
      * @brief 仅作为验证测试
      */
-    void checkForCorrect(MatrixDD root)
+    inline void checkForCorrect(MatrixDD root)
     {
         std::queue<MatrixDD> que;
         if(root.isTerminal())
@@ -99,7 +99,7 @@ namespace dd {
      * @return std::array<bool, NEDGE> 一个包含了NEDGE(4)的数组,其中的类型是bool,只要有一条出边指向的是
      * skipped node,其对应的数组索引位置的值即为true,否则为false
      */
-    std::array<bool, NEDGE> hasSkippedSubNodes(MatrixDD &mdd)
+    inline std::array<bool, NEDGE> hasSkippedSubNodes(MatrixDD &mdd)
     {
         int curIndex = mdd.p->v;
         std::array<bool, NEDGE> res{false, false, false, false};
@@ -133,7 +133,7 @@ namespace dd {
      * @return 如果存在有skipped node则返回true,否则返回false
      * @note 目前只用该文件内的系列函数侦察mNode,即只考虑quantum matrix而不考虑quantum vector
      */
-    bool isSkippedNodeExist(MatrixDD root)
+    inline bool isSkippedNodeExist(MatrixDD root)
     {
         std::queue<MatrixDD> que;
         if(root.isTerminal())
@@ -182,7 +182,7 @@ namespace dd {
      * @param index 父层节点的index
      * @param edges 保存四条出边的数组
      */
-    void printEdgesInfo(size_t index, std::array<Edge<mNode>, NEDGE> &edges)
+    inline void printEdgesInfo(size_t index, std::array<Edge<mNode>, NEDGE> &edges)
     {
         std::vector<std::pair<size_t, Edge<mNode>>> memEdges;
         for(size_t i=0;i<NEDGE;++i)
@@ -219,7 +219,7 @@ namespace dd {
     /**
      * @brief 打印出现了skipped node的节点及其父节点等相关信息
      */
-    void printSkippedNodeInfo(MatrixDD root, int &totalSkipped)
+    inline void printSkippedNodeInfo(MatrixDD root, int &totalSkipped)
     {
         if(root.p == nullptr)
         {
@@ -29,12 +29,51 @@ struct DDPackageConfig {
   static constexpr std::size_t CT_DM_DM_MULT_NBUCKET = 1U;
   static constexpr std::size_t CT_DM_ADD_NBUCKET = 1U;
 
+  // Associativity of the binary compute tables (1 = direct-mapped, 2 or 4 =
+  // set-associative with LRU replacement, see ComputeTable.hpp)
+  static constexpr std::size_t CT_VEC_ADD_NWAYS = 1U;
+  static constexpr std::size_t CT_MAT_ADD_NWAYS = 1U;
+  static constexpr std::size_t CT_DM_ADD_NWAYS = 1U;
+  static constexpr std::size_t CT_VEC_ADD_MAG_NWAYS = 1U;
+  static constexpr std::size_t CT_MAT_ADD_MAG_NWAYS = 1U;
+  static constexpr std::size_t CT_MAT_VEC_MULT_NWAYS = 1U;
+  static constexpr std::size_t CT_MAT_MAT_MULT_NWAYS = 1U;
+  static constexpr std::size_t CT_DM_DM_MULT_NWAYS = 1U;
+  static constexpr std::size_t CT_VEC_INNER_PROD_NWAYS = 1U;
+  static constexpr std::size_t CT_VEC_KRON_NWAYS = 1U;
+  static constexpr std::size_t CT_MAT_KRON_NWAYS = 1U;
+
+  // Store DD nodes in open-addressing tables with cache-line sized buckets
+  // (see BucketedUniqueTable.hpp) instead of chaining them through their
+  // `next` pointer. Applies to the vector, matrix and density matrix tables.
+  static constexpr bool UT_OPEN_ADDRESSING = false;
+
+  // Map the chunks of all memory managers via mmap with transparent huge pages
+  // (see MemoryManager.hpp) and release empty chunks after garbage collection
+  static constexpr bool MM_HUGE_PAGE_ARENA = false;
+
+  // Only inspect recorded candidates (new nodes and nodes whose reference count
+  // dropped to zero) during garbage collection instead of sweeping all buckets
+  // (see UniqueTable::setIncrementalCollection). A non-zero slice size bounds
+  // the number of candidates inspected by a single non-forced collection.
+  static constexpr bool UT_INCREMENTAL_GC = false;
+  static constexpr std::size_t UT_GC_SLICE_SIZE = 0U;
+
+  // The maximum number of gate DDs cached by getDD (see GateDDCache.hpp). Cached
+  // DDs are pinned and survive garbage collection. Zero disables the cache.
+  static constexpr std::size_t GATE_DD_CACHE_SIZE = 0U;
+
   // The number of different quantum operations. I.e., the number of operations
   // defined in OpType.hpp. This parameter is required to initialize the
   // StochasticNoiseOperationTable.hpp
   static constexpr std::size_t STOCHASTIC_CACHE_OPS = 1;
 };
 
+struct OpenAddressingDDPackageConfig : public dd::DDPackageConfig {
+  // see BucketedUniqueTable.hpp
+  static constexpr bool UT_OPEN_ADDRESSING = true;
+};
+
 struct StochasticNoiseSimulatorDDPackageConfig : public dd::DDPackageConfig {
   static constexpr std::size_t STOCHASTIC_CACHE_OPS = qc::OpType::OpCount;
 
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "dd/DDDefinitions.hpp"
+#include "dd/Node.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <string>
+
+namespace dd {
+
+/**
+ * @brief A contiguous array of complex numbers that either lives on the heap
+ * or is memory-mapped to a file.
+ * @details A file-backed buffer lets the operating system page a dense export
+ * that does not fit into memory out to disk, and keeps the result after the
+ * program exits. The contents are unspecified until they are written.
+ */
+class DenseBuffer {
+public:
+  /// A buffer of `size` entries on the heap
+  explicit DenseBuffer(std::size_t size);
+  /**
+   * @brief A buffer of `size` entries mapped to `file`
+   * @details The file is created (or truncated) and resized to hold the
+   * entries in their in-memory representation.
+   * @throws std::runtime_error if the file cannot be mapped or the platform
+   * does not support `mmap`
+   */
+  DenseBuffer(std::size_t size, const std::string& file);
+  ~DenseBuffer();
+
+  DenseBuffer(const DenseBuffer&) = delete;
+  DenseBuffer& operator=(const DenseBuffer&) = delete;
+  DenseBuffer(DenseBuffer&& other) noexcept;
+  DenseBuffer& operator=(DenseBuffer&& other) noexcept;
+
+  [[nodiscard]] std::complex<fp>* data() noexcept { return entries; }
+  [[nodiscard]] const std::complex<fp>* data() const noexcept {
+    return entries;
+  }
+  [[nodiscard]] std::size_t size() const noexcept { return count; }
+  [[nodiscard]] bool mapped() const noexcept { return isMapped; }
+
+  [[nodiscard]] std::complex<fp>& operator[](const std::size_t i) noexcept {
+    return entries[i];
+  }
+  [[nodiscard]] const std::complex<fp>&
+  operator[](const std::size_t i) const noexcept {
+    return entries[i];
+  }
+
+private:
+  void release() noexcept;
+
+  std::complex<fp>* entries = nullptr;
+  std::size_t count = 0U;
+  std::size_t bytes = 0U;
+  bool isMapped = false;
+};
+
+/**
+ * @brief Write the vector represented by a DD into a contiguous array
+ * @details The top levels of the DD are split into independent blocks that
+ * are written by `numThreads` threads. Within a block, a node that has already
+ * been written is not traversed again. Instead, its block is copied and
+ * scaled by the ratio of both path weights. Blocks behind zero edges are
+ * cleared without traversal.
+ * @param e The vector (its root must be at level nqubits - 1)
+ * @param nqubits The number of qubits
+ * @param out The array of 2^nqubits entries to write (all entries are
+ * written)
+ * @param numThreads The number of threads (0 uses all hardware threads)
+ */
+void exportDenseVector(const vEdge& e, std::size_t nqubits,
+                       std::complex<fp>* out, std::size_t numThreads = 0U);
+
+/**
+ * @brief Write the matrix represented by a DD into a contiguous row-major
+ * array
+ * @details Works like exportDenseVector. Skipped (identity) levels only write
+ * the diagonal blocks.
+ * @param e The matrix
+ * @param nqubits The number of qubits
+ * @param out The array of 2^nqubits * 2^nqubits entries to write (all entries
+ * are written)
+ * @param numThreads The number of threads (0 uses all hardware threads)
+ */
+void exportDenseMatrix(const mEdge& e, std::size_t nqubits,
+                       std::complex<fp>* out, std::size_t numThreads = 0U);
+
+/**
+ * @brief Export a vector DD into a new buffer (see exportDenseVector)
+ * @param file If not empty, the buffer is memory-mapped to this file
+ */
+[[nodiscard]] DenseBuffer getDenseVector(const vEdge& e, std::size_t nqubits,
+                                         std::size_t numThreads = 0U,
+                                         const std::string& file = "");
+
+/**
+ * @brief Export a matrix DD into a new buffer (see exportDenseMatrix)
+ * @param file If not empty, the buffer is memory-mapped to this file
+ */
+[[nodiscard]] DenseBuffer getDenseMatrix(const mEdge& e, std::size_t nqubits,
+                                         std::size_t numThreads = 0U,
+                                         const std::string& file = "");
+
+} // namespace dd
@@ -3,14 +3,54 @@
 #include "dd/DDDefinitions.hpp"
 #include "dd/statistics/TableStatistics.hpp"
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <vector>
 
 namespace dd {
 
+/// The qubits a noise operation acts on, stored inline together with their
+/// hash so that keys can be built and compared without allocating
+class NoiseQubits {
+public:
+  /// Operations on more qubits than this are not cached
+  static constexpr std::size_t CAPACITY = 8U;
+
+  NoiseQubits() = default;
+  template <class Container> explicit NoiseQubits(const Container& qubits) {
+    for (const auto qubit : qubits) {
+      if (count == CAPACITY) {
+        overflow = true;
+        return;
+      }
+      const auto q = static_cast<std::size_t>(qubit);
+      elements[count++] = static_cast<Qubit>(qubit);
+      hashValue = (hashValue << 3U) + hashValue * q + q;
+    }
+  }
+
+  [[nodiscard]] bool cacheable() const noexcept { return !overflow; }
+  [[nodiscard]] std::size_t hash() const noexcept { return hashValue; }
+
+  bool operator==(const NoiseQubits& other) const noexcept {
+    return count == other.count && overflow == other.overflow &&
+           std::equal(elements.begin(), elements.begin() + count,
+                      other.elements.begin());
+  }
+  bool operator!=(const NoiseQubits& other) const noexcept {
+    return !operator==(other);
+  }
+
+private:
+  std::array<Qubit, CAPACITY> elements{};
+  std::uint8_t count = 0U;
+  bool overflow = false;
+  std::size_t hashValue = 0U;
+};
+
 /// Data structure for caching computed results of noise operations
 /// \tparam OperandType type of the operation's operand
 /// \tparam ResultType type of the operation's result
@@ -26,7 +66,7 @@ public:
   struct Entry {
     OperandType operand;
     ResultType result;
-    std::vector<dd::Qubit> usedQubits;
+    NoiseQubits usedQubits;
   };
 
   static constexpr size_t MASK = NBUCKET - 1;
@@ -38,17 +78,15 @@ public:
   [[nodiscard]] const auto& getStats() const noexcept { return stats; }
 
   static std::size_t hash(const OperandType& a,
-                          const std::vector<Qubit>& usedQubits) {
-    std::size_t i = 0;
-    for (const auto qubit : usedQubits) {
-      i = (i << 3U) + i * static_cast<std::size_t>(qubit) +
-          static_cast<std::size_t>(qubit);
-    }
-    return (std::hash<OperandType>{}(a) + i) & MASK;
+                          const NoiseQubits& usedQubits) {
+    return (std::hash<OperandType>{}(a) + usedQubits.hash()) & MASK;
   }
 
   void insert(const OperandType& operand, const ResultType& result,
-              const std::vector<Qubit>& usedQubits) {
+              const NoiseQubits& usedQubits) {
+    if (!usedQubits.cacheable()) {
+      return;
+    }
     const auto key = hash(operand, usedQubits);
     if (valid[key]) {
       ++stats.collisions;
@@ -60,9 +98,12 @@ public:
   }
 
   ResultType lookup(const OperandType& operand,
-                    const std::vector<Qubit>& usedQubits) {
+                    const NoiseQubits& usedQubits) {
     ResultType result{};
     ++stats.lookups;
+    if (!usedQubits.cacheable()) {
+      return result;
+    }
     const auto key = hash(operand, usedQubits);
 
     if (!valid[key]) {
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "dd/DDDefinitions.hpp"
+#include "dd/Package_fwd.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dd {
+
+enum class EquivalenceCriterion : std::uint8_t {
+  NotEquivalent,
+  Equivalent,
+  EquivalentUpToGlobalPhase
+};
+
+struct EquivalenceCheckingConfig {
+  /// Stop as soon as the intermediate DD proves that the circuits differ
+  bool earlyExit = true;
+  /// Reorder the variables of the intermediate DD via sifting when it grows
+  bool reorder = false;
+  /// The size of the intermediate DD that triggers the first reordering
+  std::size_t reorderThreshold = 1024U;
+  /// The factor by which the DD has to grow after a reordering to trigger the
+  /// next one
+  double reorderGrowthFactor = 2.;
+  /// The tolerance used when comparing the result to the identity
+  fp tolerance = 1e-10;
+};
+
+struct EquivalenceCheckingResult {
+  EquivalenceCriterion equivalence = EquivalenceCriterion::NotEquivalent;
+  /// Whether non-equivalence was shown before all gates were applied
+  bool earlyExit = false;
+  /// The number of gates applied from the first and the second circuit
+  std::size_t appliedGates1 = 0U;
+  std::size_t appliedGates2 = 0U;
+  /// The number of reorderings that have been applied to the intermediate DD
+  std::size_t reorderings = 0U;
+  /// The maximum size of the intermediate DD
+  std::size_t peakNodes = 0U;
+  /// The peak number of active matrix nodes in the package
+  std::size_t peakActiveNodes = 0U;
+  /// The runtime in seconds
+  double runtime = 0.;
+};
+
+/**
+ * @brief Check the equivalence of two circuits by computing G·G'† from both
+ * ends.
+ * @details Starting from the identity, the gates of `qc1` are applied from the
+ * left and the inverted gates of `qc2` from the right. In every step, both
+ * candidates are computed and the smaller one is kept, so that the
+ * intermediate DD stays close to the identity if the circuits are equivalent.
+ * Neither functionality is ever built on its own.
+ *
+ * Once no remaining gate (nor the final permutation, ancillary or garbage
+ * handling) acts on a qubit, the intermediate DD has to act as the identity on
+ * that qubit for the circuits to be equivalent. With `earlyExit` set, this is
+ * checked whenever qubits are finished and the check stops as soon as it
+ * fails.
+ *
+ * With `reorder` set, the intermediate DD is sifted (see reorderSelect) once
+ * it exceeds the configured size. Sifting rewrites nodes in place, so it is
+ * performed on a copy in a scratch package. The resulting variable order is
+ * then established in `dd` by conjugating the intermediate DD with SWAP gates
+ * and is only kept if it reduces the size. Subsequent gates are mapped to the
+ * new order and the original order is restored before the result is compared
+ * to the identity.
+ * @param qc1 The first circuit
+ * @param qc2 The second circuit (with the same number of qubits)
+ * @param dd The package to use
+ * @param config The configuration of the check
+ * @return The verdict and statistics of the check
+ */
+template <class Config>
+EquivalenceCheckingResult
+checkEquivalence(const qc::QuantumComputation* qc1,
+                 const qc::QuantumComputation* qc2, Package<Config>& dd,
+                 const EquivalenceCheckingConfig& config = {});
+
+} // namespace dd
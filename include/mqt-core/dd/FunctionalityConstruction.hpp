@@ -1,15 +1,19 @@
 #pragma once
 
+#include "dd/Checkpoint.hpp"
 #include "dd/Operations.hpp"
 #include "dd/Package_fwd.hpp"
+#include "Definitions.hpp"
 #include "ir/Permutation.hpp"
 #include "ir/QuantumComputation.hpp"
 #include "ir/operations/OpType.hpp"
 
 #include <cstddef>
+#include <istream>
 #include <memory>
 #include <ostream>
 #include <stack>
+#include <string>
 #include <vector>
 
 namespace dd {
@@ -18,6 +22,101 @@ using namespace qc;
 template <class Config>
 MatrixDD buildFunctionality(const QuantumComputation* qc, Package<Config>& dd);
 
+/**
+ * @brief Build the functionality of a circuit while periodically writing
+ * checkpoints.
+ * @details Whenever a checkpoint is due (see CheckpointConfig), the current
+ * DD, the index of the next operation and the permutation are written to
+ * `checkpoint.file` in the background (see Checkpointer).
+ * @param qc The circuit
+ * @param dd The package to use
+ * @param checkpoint When and where to write checkpoints
+ * @return The functionality of the circuit
+ */
+template <class Config>
+MatrixDD buildFunctionality(const QuantumComputation* qc, Package<Config>& dd,
+                            const CheckpointConfig& checkpoint);
+
+/**
+ * @brief Continue building the functionality of a circuit from a checkpoint.
+ * @param qc The circuit the checkpoint was written for
+ * @param dd The package to use
+ * @param file The checkpoint to resume from
+ * @param checkpoint When and where to write further checkpoints
+ * @throws std::invalid_argument if the checkpoint belongs to a circuit with a
+ * different number of operations
+ * @return The functionality of the circuit
+ */
+template <class Config>
+MatrixDD resumeFunctionality(const QuantumComputation* qc, Package<Config>& dd,
+                             const std::string& file,
+                             const CheckpointConfig& checkpoint = {});
+
+/**
+ * @brief Build the functionality of a circuit after fusing its gates into
+ * blocks.
+ * @details Consecutive gates acting on at most `maxBlockSize` qubits are
+ * grouped into blocks (see qc::CircuitOptimizer::collectBlocks). The DD of each
+ * block only acts on the block's qubits and is therefore cheap to build. It is
+ * multiplied into the accumulated functionality once instead of multiplying
+ * every gate of the block into the (much larger) accumulated DD.
+ * @param qc The circuit (not modified)
+ * @param dd The package to use
+ * @param maxBlockSize The maximum number of qubits of a block
+ * @return The functionality of the circuit
+ */
+template <class Config>
+MatrixDD buildFunctionalityFused(const QuantumComputation* qc,
+                                 Package<Config>& dd, std::size_t maxBlockSize);
+
+/**
+ * @brief Build the functionality of a circuit using multiple threads.
+ * @details The circuit is split into `numThreads` contiguous chunks of gates.
+ * Each chunk's product is built by its own thread in a private package, so
+ * that no synchronization of the tables is required. The products are then
+ * combined pairwise in a binary tree, where every round runs in parallel and
+ * moves DDs between the private packages via Package::transfer. Finally, the
+ * result is transferred into `dd`.
+ * @param qc The circuit
+ * @param dd The package to use for the result
+ * @param numThreads The number of threads to use (0 selects the number of
+ * hardware threads)
+ * @return The functionality of the circuit
+ */
+template <class Config>
+MatrixDD buildFunctionalityParallel(const QuantumComputation* qc,
+                                   Package<Config>& dd,
+                                   std::size_t numThreads = 0U);
+
+/**
+ * @brief Build the functionality of a circuit while its file is being parsed.
+ * @details The circuit is imported via QuantumComputation::importStreaming,
+ * i.e., its operations are never materialized. Each operation is multiplied
+ * into the functionality as soon as the parser creates it. If `concurrent` is
+ * set, the file is parsed on a second thread, which hands the operations to
+ * the building thread via a bounded queue. The package is resized if the
+ * circuit acts on more qubits than the package supports.
+ * @param filename The file to import (the format is derived from the
+ * extension)
+ * @param dd The package to use
+ * @param concurrent Whether to parse and build on separate threads
+ * @param queueCapacity The maximum number of parsed operations waiting to be
+ * processed in concurrent mode
+ * @return The functionality of the circuit
+ */
+template <class Config>
+MatrixDD buildFunctionalityStreaming(const std::string& filename,
+                                    Package<Config>& dd,
+                                    bool concurrent = false,
+                                    std::size_t queueCapacity = 1024U);
+
+/// @see buildFunctionalityStreaming
+template <class Config>
+MatrixDD buildFunctionalityStreaming(std::istream& is, Format format,
+                                    Package<Config>& dd,
+                                    bool concurrent = false,
+                                    std::size_t queueCapacity = 1024U);
+
 template <class Config>
 MatrixDD buildFunctionalityRecursive(const QuantumComputation* qc,
                                      Package<Config>& dd);
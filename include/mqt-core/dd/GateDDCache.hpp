@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/statistics/TableStatistics.hpp"
+#include "ir/operations/Control.hpp"
+#include "ir/operations/OpType.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dd {
+
+/**
+ * @brief Identifies the DD of a gate
+ * @details The targets and controls are the qubits the gate acts on after
+ * applying the permutation of the circuit (if any).
+ */
+struct GateDDKey {
+  qc::OpType type = qc::OpType::None;
+  std::vector<fp> parameter{};
+  std::vector<qc::Qubit> targets{};
+  qc::Controls controls{};
+  bool inverse = false;
+
+  bool operator==(const GateDDKey& other) const {
+    return type == other.type && inverse == other.inverse &&
+           parameter == other.parameter && targets == other.targets &&
+           controls == other.controls;
+  }
+};
+
+struct GateDDKeyHash {
+  std::size_t operator()(const GateDDKey& key) const noexcept {
+    auto h = std::hash<std::size_t>{}(static_cast<std::size_t>(key.type));
+    qc::hashCombine(h, static_cast<std::size_t>(key.inverse));
+    for (const auto& p : key.parameter) {
+      qc::hashCombine(h, std::hash<fp>{}(p));
+    }
+    for (const auto& t : key.targets) {
+      qc::hashCombine(h, t);
+    }
+    for (const auto& c : key.controls) {
+      qc::hashCombine(h, c.qubit);
+      qc::hashCombine(h, static_cast<std::size_t>(c.type));
+    }
+    return h;
+  }
+};
+
+/**
+ * @brief A bounded cache for the DDs of gates
+ * @details Circuits frequently apply the same gates (e.g., the Toffoli and
+ * CNOT patterns of reversible circuits) over and over again. Caching their DDs
+ * avoids rebuilding them for every occurrence. The cache keeps at most
+ * `capacity` entries and evicts the least recently used one. It does not manage
+ * reference counts itself: the package pins cached DDs on insertion and
+ * unpins the DDs returned on eviction (see Package::insertGateDD).
+ * @tparam Edge The type of the cached DDs
+ */
+template <class Edge> class GateDDCache {
+public:
+  explicit GateDDCache(const std::size_t cap) : capacity(cap) {
+    stats.entrySize = sizeof(Entry);
+    stats.numBuckets = cap;
+  }
+
+  /// Get a reference to the statistics
+  [[nodiscard]] const auto& getStats() const noexcept { return stats; }
+
+  [[nodiscard]] std::size_t getCapacity() const noexcept { return capacity; }
+
+  /**
+   * @brief Lookup the DD of a gate
+   * @return A pointer to the cached DD or nullptr if the gate is not cached
+   */
+  [[nodiscard]] const Edge* lookup(const GateDDKey& key) {
+    ++stats.lookups;
+    const auto it = index.find(key);
+    if (it == index.end()) {
+      return nullptr;
+    }
+    ++stats.hits;
+    // mark as most recently used
+    entries.splice(entries.begin(), entries, it->second);
+    return &it->second->second;
+  }
+
+  /**
+   * @brief Insert the DD of a gate
+   * @return The DD that has to be unpinned, i.e., the evicted DD or the
+   * given DD itself if it was not inserted
+   */
+  std::optional<Edge> insert(GateDDKey key, const Edge& e) {
+    if (capacity == 0U || index.find(key) != index.end()) {
+      return e;
+    }
+    std::optional<Edge> evicted{};
+    if (entries.size() >= capacity) {
+      auto& last = entries.back();
+      evicted = last.second;
+      index.erase(last.first);
+      entries.pop_back();
+      --stats.numEntries;
+    }
+    entries.emplace_front(std::move(key), e);
+    index.emplace(entries.front().first, entries.begin());
+    stats.trackInsert();
+    return evicted;
+  }
+
+  /// Apply a function to all cached DDs
+  template <class F> void forEach(F&& f) const {
+    for (const auto& [key, e] : entries) {
+      std::invoke(f, e);
+    }
+  }
+
+  void clear() {
+    entries.clear();
+    index.clear();
+    stats.numEntries = 0U;
+  }
+
+private:
+  using Entry = std::pair<GateDDKey, Edge>;
+
+  std::size_t capacity;
+  /// The cached DDs ordered from the most to the least recently used
+  std::list<Entry> entries{};
+  std::unordered_map<GateDDKey, typename std::list<Entry>::iterator,
+                     GateDDKeyHash>
+      index{};
+  TableStatistics stats{};
+};
+
+} // namespace dd
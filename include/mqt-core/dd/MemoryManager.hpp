@@ -19,6 +19,15 @@ namespace dd {
  * returned. If the list is empty, an object from the current chunk is returned.
  * If the current chunk is full, a new chunk is allocated. The size of chunks
  * grows exponentially according to a growth factor.
+ *
+ * Chunks are either taken from the heap or, if the arena backend is enabled,
+ * mapped directly from the operating system via `mmap`. Arena chunks are
+ * rounded up to a multiple of the huge page size and advised to be backed by
+ * transparent huge pages (`MADV_HUGEPAGE`), which reduces TLB misses for large
+ * decision diagrams. Entries are only constructed once they are handed out for
+ * the first time, so pages of a chunk are not touched before they are needed.
+ * Chunks whose entries have all been returned can be given back to the
+ * operating system via releaseEmptyChunks().
  * @note The main purpose of this class is to reduce the number of memory
  * allocations and deallocations. This is achieved by allocating a large number
  * of objects at once and reusing them. This is especially useful for objects
@@ -31,6 +40,8 @@ template <typename T> class MemoryManager {
                 "T must have a `next` member of type T*");
   static_assert(std::is_same_v<decltype(T::ref), RefCount>,
                 "T must have a `ref` member of type RefCount");
+  static_assert(std::is_trivially_destructible_v<T>,
+                "T must be trivially destructible");
 
 public:
   /**
@@ -50,20 +61,31 @@ public:
    */
   static constexpr double GROWTH_FACTOR = 2U;
 
+  /**
+   * @brief The granularity of arena chunks in bytes
+   * @details Arena chunks are rounded up to a multiple of the (typical) size of
+   * a transparent huge page, so that the kernel can back them by huge pages.
+   */
+  static constexpr std::size_t HUGE_PAGE_SIZE = 2ULL << 20U;
+
   /**
    * @brief Construct a new MemoryManager object
    * @param initialAllocationSize The initial number of entries to allocate
+   * @param useArena Whether to map chunks via `mmap` with huge page support
+   * instead of allocating them on the heap. Falls back to the heap on
+   * platforms without `mmap`.
    */
   explicit MemoryManager(
-      const std::size_t initialAllocationSize = INITIAL_ALLOCATION_SIZE)
-      : chunks(1, std::vector<T>(initialAllocationSize)),
-        chunkIt(chunks[0].begin()), chunkEndIt(chunks[0].end()) {
-    stats.numAllocations = 1U;
-    stats.numAllocated = initialAllocationSize;
-  }
+      std::size_t initialAllocationSize = INITIAL_ALLOCATION_SIZE,
+      bool useArena = false);
 
-  /// default destructor
-  ~MemoryManager() = default;
+  /// Returns all chunks to the heap or the operating system
+  ~MemoryManager();
+
+  MemoryManager(const MemoryManager&) = delete;
+  MemoryManager& operator=(const MemoryManager&) = delete;
+  MemoryManager(MemoryManager&&) = delete;
+  MemoryManager& operator=(MemoryManager&&) = delete;
 
   /**
    * @brief Get an entry from the manager.
@@ -95,7 +117,20 @@ public:
    * @param resizeToTotal If set to true, the first chunk is resized to the
    * total number of entries.
    */
-  void reset(bool resizeToTotal = false) noexcept;
+  void reset(bool resizeToTotal = false);
+
+  /**
+   * @brief Release chunks that are no longer in use.
+   * @details A chunk is released if all of its entries are on the list of
+   * available entries. The entries are removed from the list and the memory
+   * is returned to the heap or the operating system. The current chunk is
+   * never released. This is meant to be called after garbage collection.
+   * @return The number of released chunks.
+   */
+  std::size_t releaseEmptyChunks();
+
+  /// Whether chunks are mapped via the arena backend
+  [[nodiscard]] bool usesArena() const noexcept { return arena; }
 
   /// Get a reference to the statistics
   [[nodiscard]] const auto& getStats() const noexcept { return stats; }
@@ -127,6 +162,25 @@ private:
   /// Allocate a new chunk of memory
   void allocateNewChunk();
 
+  /**
+   * @brief A contiguous block of (not necessarily constructed) entries
+   * @details `bytes` is the size of the underlying allocation, which may
+   * exceed `size * sizeof(T)` for arena chunks.
+   */
+  struct Chunk {
+    T* data = nullptr;
+    std::size_t size = 0U;
+    std::size_t bytes = 0U;
+    bool mapped = false;
+  };
+
+  /// Allocate a chunk with at least `numEntries` entries
+  [[nodiscard]] Chunk allocateChunk(std::size_t numEntries) const;
+  /// Return the memory of a chunk to the heap or the operating system
+  static void releaseChunk(const Chunk& chunk) noexcept;
+  /// Append a chunk and make it the current one
+  void pushChunk(const Chunk& chunk);
+
   /**
    * @brief Get an entry from the current chunk
    * @return A pointer to an entry from the current chunk
@@ -143,26 +197,29 @@ private:
    */
   T* available{};
 
+  /// Whether chunks are mapped via `mmap` instead of allocated on the heap
+  bool arena = false;
+
   /**
    * @brief The storage for the entries
-   * @details The MemoryManager maintains a vector of chunks. Each chunk is a
-   * vector of entries. Entries in a chunk are allocated contiguously.
+   * @details The MemoryManager maintains a vector of chunks. Entries in a chunk
+   * are allocated contiguously. The last chunk is the current one.
    */
-  std::vector<std::vector<T>> chunks;
+  std::vector<Chunk> chunks;
 
   /**
-   * @brief Iterator to the next available entry in the current chunk
-   * @details This iterator points to the next available entry in the current
+   * @brief Pointer to the next available entry in the current chunk
+   * @details This pointer points to the next available entry in the current
    * chunk. If the current chunk is full, it points to the end of the chunk.
    */
-  typename std::vector<T>::iterator chunkIt;
+  T* chunkIt{};
 
   /**
-   * @brief Iterator to the end of the current chunk
-   * @details This iterator points to the end of the current chunk. It is used
+   * @brief Pointer to the end of the current chunk
+   * @details This pointer points to the end of the current chunk. It is used
    * to determine whether the current chunk is full.
    */
-  typename std::vector<T>::iterator chunkEndIt;
+  T* chunkEndIt{};
 
   /// Memory manager statistics
   MemoryManagerStatistics<T> stats{};
@@ -13,13 +13,14 @@ namespace dd {
 
 /**
  * @brief A vector DD node
- * @details Data Layout |24|24|8|4|2| = 62B (space for two more bytes)
+ * @details Data Layout |24|24|8|4|2|1| = 63B (space for one more byte)
  */
 struct vNode {                        // NOLINT(readability-identifier-naming)
   std::array<Edge<vNode>, RADIX> e{}; // edges out of this node
   vNode* next{};                      // used to link nodes in unique table
   RefCount ref{};                     // reference count
   Qubit v{};                          // variable index
+  std::uint8_t generation = 0;        // bumped when the node is reclaimed
 
   static constexpr bool isTerminal(const vNode* p) noexcept {
     return p == nullptr;
@@ -31,7 +32,7 @@ using vCachedEdge = CachedEdge<vNode>;
 
 /**
  * @brief A matrix DD node
- * @details Data Layout |24|24|24|24|8|4|2|1| = 111B (space for one more byte)
+ * @details Data Layout |24|24|24|24|8|4|2|1|1| = 112B
  */
 struct mNode {                        // NOLINT(readability-identifier-naming)
   std::array<Edge<mNode>, NEDGE> e{}; // edges out of this node
@@ -39,6 +40,7 @@ struct mNode {                        // NOLINT(readability-identifier-naming)
   RefCount ref{};                     // reference count
   Qubit v{};                          // variable index
   std::uint8_t flags = 0;
+  std::uint8_t generation = 0;        // bumped when the node is reclaimed
   // 32 = unused (was used to mark a node which is symmetric)
   // 16 = unused (was used to mark a node resembling the identity)
   // 8 = marks a reduced dm node,
@@ -61,9 +63,43 @@ struct mNode {                        // NOLINT(readability-identifier-naming)
 using mEdge = Edge<mNode>;
 using mCachedEdge = CachedEdge<mNode>;
 
+/**
+ * @brief Access to the generation of nodes referenced by compute tables
+ * @details Vector and matrix nodes carry a generation counter that is
+ * incremented whenever the node is reclaimed by garbage collection. Compute
+ * tables record the generations of all nodes referenced by an entry and treat
+ * the entry as a miss once any of them changed. This way, garbage collection
+ * only invalidates entries that actually reference reclaimed nodes. Only node
+ * pointers and cached edges (whose weights are stored by value) are tracked.
+ */
+template <class T> struct NodeGeneration {
+  static constexpr bool TRACKED = false;
+  static constexpr std::uint8_t of(const T& /*x*/) noexcept { return 0U; }
+};
+
+template <class Node> struct NodePointerGeneration {
+  static constexpr bool TRACKED = true;
+  static std::uint8_t of(const Node* p) noexcept {
+    return Node::isTerminal(p) ? 0U : p->generation;
+  }
+};
+template <> struct NodeGeneration<vNode*> : NodePointerGeneration<vNode> {};
+template <> struct NodeGeneration<mNode*> : NodePointerGeneration<mNode> {};
+
+template <class Node> struct CachedEdgeGeneration {
+  static constexpr bool TRACKED = true;
+  static std::uint8_t of(const CachedEdge<Node>& e) noexcept {
+    return NodePointerGeneration<Node>::of(e.p);
+  }
+};
+template <>
+struct NodeGeneration<vCachedEdge> : CachedEdgeGeneration<vNode> {};
+template <>
+struct NodeGeneration<mCachedEdge> : CachedEdgeGeneration<mNode> {};
+
 /**
  * @brief A density matrix DD node
- * @details Data Layout |24|24|24|24|8|4|2|1| = 111B (space for one more byte)
+ * @details Data Layout |24|24|24|24|8|4|2|1|1| = 112B
  */
 struct dNode {                        // NOLINT(readability-identifier-naming)
   std::array<Edge<dNode>, NEDGE> e{}; // edges out of this node
@@ -71,6 +107,7 @@ struct dNode {                        // NOLINT(readability-identifier-naming)
   RefCount ref{};                     // reference count
   Qubit v{};                          // variable index
   std::uint8_t flags = 0;
+  std::uint8_t generation = 0;        // bumped when the node is reclaimed
   // 32 = unused (was used to mark a node which is symmetric)
   // 16 = unused (was used to mark a node resembling the identity)
   // 8 = marks a reduced dm node,
@@ -3,8 +3,11 @@
 #include "Definitions.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
+#include "dd/DensityNoiseTable.hpp"
 #include "dd/Node.hpp"
 #include "dd/Package.hpp"
+#include "dd/Sampler.hpp"
+#include "ir/QuantumComputation.hpp"
 #include "ir/operations/OpType.hpp"
 #include "ir/operations/Operation.hpp"
 
@@ -122,7 +125,8 @@ public:
 private:
   dCachedEdge applyNoiseEffects(dEdge& originalEdge,
                                 const std::set<qc::Qubit>& usedQubits,
-                                bool firstPathEdge, Qubit level);
+                                const NoiseQubits& key, bool firstPathEdge,
+                                Qubit level);
 
   static void applyPhaseFlipToEdges(ArrayOfEdges& e, double probability);
 
@@ -131,4 +135,33 @@ private:
   void applyDepolarisationToEdges(ArrayOfEdges& e, double probability);
 };
 
+/**
+ * @brief Sample a noisy circuit by simulating stochastic noise trajectories in
+ * parallel.
+ * @details Every worker owns a separate package (and noise functionality) and
+ * repeatedly claims the next trajectory from a shared atomic counter.
+ * The random number generator of a trajectory is seeded from `seed` and the
+ * index of the trajectory only, so the result does not depend on the number
+ * of threads. Non-unitary operations are skipped. The final state of each
+ * trajectory is sampled `shotsPerTrajectory` times (see Sampler) into a
+ * histogram owned by the worker, and the histograms are only merged once all
+ * workers have finished.
+ * @param qc The circuit to simulate
+ * @param trajectories The number of trajectories
+ * @param shotsPerTrajectory The number of shots drawn from each trajectory
+ * @param gateNoiseProbability See StochasticNoiseFunctionality
+ * @param amplitudeDampingProb See StochasticNoiseFunctionality
+ * @param multiQubitGateFactor See StochasticNoiseFunctionality
+ * @param noiseEffects See StochasticNoiseFunctionality
+ * @param seed The seed of the experiment (0 draws a random seed)
+ * @param numThreads The number of workers (0 uses all hardware threads)
+ * @return The histogram of the measured outcomes (bit i holds qubit i)
+ */
+Histogram simulateStochasticTrajectories(
+    const qc::QuantumComputation& qc, std::size_t trajectories,
+    std::size_t shotsPerTrajectory, double gateNoiseProbability,
+    double amplitudeDampingProb, double multiQubitGateFactor,
+    const std::string& noiseEffects, std::size_t seed = 0U,
+    std::size_t numThreads = 0U);
+
 } // namespace dd
@@ -2,6 +2,7 @@
 
 #include "Definitions.hpp"
 #include "dd/DDDefinitions.hpp"
+#include "dd/GateDDCache.hpp"
 #include "dd/GateMatrixDefinitions.hpp"
 #include "dd/Package.hpp"
 #include "ir/Permutation.hpp"
@@ -211,14 +212,26 @@ qc::MatrixDD getDD(const qc::Operation* op, Package<Config>& dd,
       controls = permutation.apply(controls);
     }
 
-    if (qc::isTwoQubitGate(type)) {
-      assert(targets.size() == 2);
+    const auto build = [&]() {
+      if (qc::isTwoQubitGate(type)) {
+        assert(targets.size() == 2);
+        return getStandardOperationDD(standardOp, dd, controls, targets[0U],
+                                      targets[1U], inverse);
+      }
+      assert(targets.size() == 1);
       return getStandardOperationDD(standardOp, dd, controls, targets[0U],
-                                    targets[1U], inverse);
+                                    inverse);
+    };
+    if constexpr (Config::GATE_DD_CACHE_SIZE > 0U) {
+      GateDDKey key{type, op->getParameter(), targets, controls, inverse};
+      if (const auto* cached = dd.lookupGateDD(key); cached != nullptr) {
+        return *cached;
+      }
+      const auto e = build();
+      dd.insertGateDD(std::move(key), e);
+      return e;
     }
-    assert(targets.size() == 1);
-    return getStandardOperationDD(standardOp, dd, controls, targets[0U],
-                                  inverse);
+    return build();
   }
 
   if (const auto* compoundOp = dynamic_cast<const qc::CompoundOperation*>(op)) {
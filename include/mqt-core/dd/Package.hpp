@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Definitions.hpp"
+#include "dd/BucketedUniqueTable.hpp"
 #include "dd/CachedEdge.hpp"
 #include "dd/Complex.hpp"
 #include "dd/ComplexNumbers.hpp"
@@ -10,6 +11,7 @@
 #include "dd/DDpackageConfig.hpp"
 #include "dd/DensityNoiseTable.hpp"
 #include "dd/Edge.hpp"
+#include "dd/GateDDCache.hpp"
 #include "dd/GateMatrixDefinitions.hpp"
 #include "dd/MemoryManager.hpp"
 #include "dd/Node.hpp"
@@ -24,16 +26,19 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <queue>
 #include <random>
 #include <regex>
@@ -41,6 +46,7 @@
 #include <stack>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -64,6 +70,11 @@ public:
   static constexpr std::size_t DEFAULT_QUBITS = 32U;
   explicit Package(std::size_t nq = DEFAULT_QUBITS) : nqubits(nq) {
     resize(nq);
+    if constexpr (Config::UT_INCREMENTAL_GC) {
+      vUniqueTable.setIncrementalCollection(true, Config::UT_GC_SLICE_SIZE);
+      mUniqueTable.setIncrementalCollection(true, Config::UT_GC_SLICE_SIZE);
+      dUniqueTable.setIncrementalCollection(true, Config::UT_GC_SLICE_SIZE);
+    }
   };
 
   std::array<int, MAX_POSSIBLE_QUBITS> active{};
@@ -92,6 +103,8 @@ public:
 
   // reset package state
   void reset() {
+    // the nodes of the cached gates are discarded below
+    gateDDCache.clear();
     clearUniqueTables();
     resetMemoryManagers();
     clearComputeTables();
@@ -105,17 +118,22 @@ private:
 
 public:
   /// The memory manager for vector nodes
-  MemoryManager<vNode> vMemoryManager{Config::UT_VEC_INITIAL_ALLOCATION_SIZE};
+  MemoryManager<vNode> vMemoryManager{Config::UT_VEC_INITIAL_ALLOCATION_SIZE,
+                                      Config::MM_HUGE_PAGE_ARENA};
   /// The memory manager for matrix nodes
-  MemoryManager<mNode> mMemoryManager{Config::UT_MAT_INITIAL_ALLOCATION_SIZE};
+  MemoryManager<mNode> mMemoryManager{Config::UT_MAT_INITIAL_ALLOCATION_SIZE,
+                                      Config::MM_HUGE_PAGE_ARENA};
   /// The memory manager for density matrix nodes
-  MemoryManager<dNode> dMemoryManager{Config::UT_DM_INITIAL_ALLOCATION_SIZE};
+  MemoryManager<dNode> dMemoryManager{Config::UT_DM_INITIAL_ALLOCATION_SIZE,
+                                      Config::MM_HUGE_PAGE_ARENA};
   /**
    * @brief The memory manager for complex numbers
    * @note The real and imaginary part of complex numbers are treated
    * separately. Hence, it suffices for the manager to only manage real numbers.
    */
-  MemoryManager<RealNumber> cMemoryManager;
+  MemoryManager<RealNumber> cMemoryManager{
+      MemoryManager<RealNumber>::INITIAL_ALLOCATION_SIZE,
+      Config::MM_HUGE_PAGE_ARENA};
 
   /**
    * @brief Get the memory manager for a given type
@@ -147,12 +165,22 @@ public:
     cMemoryManager.reset(resizeToTotal);
   }
 
+  /// The unique table layout selected by the configuration
+  template <class Node, std::size_t NBUCKET>
+  using UniqueTableType =
+      std::conditional_t<Config::UT_OPEN_ADDRESSING,
+                         BucketedUniqueTable<Node, NBUCKET>,
+                         UniqueTable<Node, NBUCKET>>;
+
   /// The unique table used for vector nodes
-  UniqueTable<vNode, Config::UT_VEC_NBUCKET> vUniqueTable{0U, vMemoryManager};
+  UniqueTableType<vNode, Config::UT_VEC_NBUCKET> vUniqueTable{0U,
+                                                              vMemoryManager};
   /// The unique table used for matrix nodes
-  UniqueTable<mNode, Config::UT_MAT_NBUCKET> mUniqueTable{0U, mMemoryManager};
+  UniqueTableType<mNode, Config::UT_MAT_NBUCKET> mUniqueTable{0U,
+                                                              mMemoryManager};
   /// The unique table used for density matrix nodes
-  UniqueTable<dNode, Config::UT_DM_NBUCKET> dUniqueTable{0U, dMemoryManager};
+  UniqueTableType<dNode, Config::UT_DM_NBUCKET> dUniqueTable{0U,
+                                                             dMemoryManager};
   /**
    * @brief The unique table used for complex numbers
    * @note The table actually only stores real numbers in the interval [0, 1],
@@ -260,44 +288,51 @@ public:
     auto mCollect = mUniqueTable.garbageCollect(force);
     auto dCollect = dUniqueTable.garbageCollect(force);
 
-    // invalidate all compute tables involving vectors if any vector node has
-    // been collected
-    if (vCollect > 0) {
+    // give chunks that only contain collected entries back to the system
+    bool vReleased = false;
+    bool mReleased = false;
+    if constexpr (Config::MM_HUGE_PAGE_ARENA) {
+      vReleased = vCollect > 0 && vMemoryManager.releaseEmptyChunks() > 0;
+      mReleased = mCollect > 0 && mMemoryManager.releaseEmptyChunks() > 0;
+      if (dCollect > 0) {
+        dMemoryManager.releaseEmptyChunks();
+      }
+      if (cCollect > 0) {
+        cMemoryManager.releaseEmptyChunks();
+      }
+    }
+
+    // Entries of the vector and matrix compute tables record the generations
+    // of the nodes they reference and are invalidated lazily on lookup once a
+    // referenced node has been reclaimed (see NodeGeneration). They only store
+    // edge weights by value and, hence, are not affected by collecting complex
+    // numbers. The tables only have to be cleared if a generation counter
+    // wrapped around or if the memory of collected nodes has been released.
+    if (vUniqueTable.consumeGenerationWrap() || vReleased) {
       vectorAdd.clear();
+      vectorAddMagnitudes.clear();
+      conjugateVector.clear();
       vectorInnerProduct.clear();
       vectorKronecker.clear();
       matrixVectorMultiplication.clear();
     }
-    // invalidate all compute tables involving matrices if any matrix node has
-    // been collected
-    if (mCollect > 0) {
+    if (mUniqueTable.consumeGenerationWrap() || mReleased) {
       matrixAdd.clear();
+      matrixAddMagnitudes.clear();
       conjugateMatrixTranspose.clear();
       matrixKronecker.clear();
       matrixTrace.clear();
       matrixVectorMultiplication.clear();
       matrixMatrixMultiplication.clear();
+    }
+    // the stochastic noise cache stores edges with weights from the complex
+    // table
+    if (mCollect > 0 || cCollect > 0) {
       stochasticNoiseOperationCache.clear();
     }
     // invalidate all compute tables involving density matrices if any density
-    // matrix node has been collected
-    if (dCollect > 0) {
-      densityAdd.clear();
-      densityDensityMultiplication.clear();
-      densityNoise.clear();
-      densityTrace.clear();
-    }
-    // invalidate all compute tables where any component of the entry contains
-    // numbers from the complex table if any complex numbers were collected
-    if (cCollect > 0) {
-      matrixVectorMultiplication.clear();
-      matrixMatrixMultiplication.clear();
-      conjugateMatrixTranspose.clear();
-      vectorInnerProduct.clear();
-      vectorKronecker.clear();
-      matrixKronecker.clear();
-      matrixTrace.clear();
-      stochasticNoiseOperationCache.clear();
+    // matrix node or complex number has been collected
+    if (dCollect > 0 || cCollect > 0) {
       densityAdd.clear();
       densityDensityMultiplication.clear();
       densityNoise.clear();
@@ -913,6 +948,7 @@ public:
     matrixTrace.clear();
 
     stochasticNoiseOperationCache.clear();
+    clearGateDDCache();
     densityAdd.clear();
     densityDensityMultiplication.clear();
     densityNoise.clear();
@@ -1195,12 +1231,13 @@ public:
   /// Addition
   ///
   ComputeTable<vCachedEdge, vCachedEdge, vCachedEdge,
-               Config::CT_VEC_ADD_NBUCKET>
+               Config::CT_VEC_ADD_NBUCKET, Config::CT_VEC_ADD_NWAYS>
       vectorAdd{};
   ComputeTable<mCachedEdge, mCachedEdge, mCachedEdge,
-               Config::CT_MAT_ADD_NBUCKET>
+               Config::CT_MAT_ADD_NBUCKET, Config::CT_MAT_ADD_NWAYS>
       matrixAdd{};
-  ComputeTable<dCachedEdge, dCachedEdge, dCachedEdge, Config::CT_DM_ADD_NBUCKET>
+  ComputeTable<dCachedEdge, dCachedEdge, dCachedEdge, Config::CT_DM_ADD_NBUCKET,
+               Config::CT_DM_ADD_NWAYS>
       densityAdd{};
 
   template <class Node> [[nodiscard]] auto& getAddComputeTable() {
@@ -1214,10 +1251,10 @@ public:
   }
 
   ComputeTable<vCachedEdge, vCachedEdge, vCachedEdge,
-               Config::CT_VEC_ADD_MAG_NBUCKET>
+               Config::CT_VEC_ADD_MAG_NBUCKET, Config::CT_VEC_ADD_MAG_NWAYS>
       vectorAddMagnitudes{};
   ComputeTable<mCachedEdge, mCachedEdge, mCachedEdge,
-               Config::CT_MAT_ADD_MAG_NBUCKET>
+               Config::CT_MAT_ADD_MAG_NBUCKET, Config::CT_MAT_ADD_MAG_NWAYS>
       matrixAddMagnitudes{};
 
   template <class Node> [[nodiscard]] auto& getAddMagnitudesComputeTable() {
@@ -1489,11 +1526,14 @@ public:
   ///
   /// Multiplication
   ///
-  ComputeTable<mNode*, vNode*, vCachedEdge, Config::CT_MAT_VEC_MULT_NBUCKET>
+  ComputeTable<mNode*, vNode*, vCachedEdge, Config::CT_MAT_VEC_MULT_NBUCKET,
+               Config::CT_MAT_VEC_MULT_NWAYS>
       matrixVectorMultiplication{};
-  ComputeTable<mNode*, mNode*, mCachedEdge, Config::CT_MAT_MAT_MULT_NBUCKET>
+  ComputeTable<mNode*, mNode*, mCachedEdge, Config::CT_MAT_MAT_MULT_NBUCKET,
+               Config::CT_MAT_MAT_MULT_NWAYS>
       matrixMatrixMultiplication{};
-  ComputeTable<dNode*, dNode*, dCachedEdge, Config::CT_DM_DM_MULT_NBUCKET>
+  ComputeTable<dNode*, dNode*, dCachedEdge, Config::CT_DM_DM_MULT_NBUCKET,
+               Config::CT_DM_DM_MULT_NWAYS>
       densityDensityMultiplication{};
 
   template <class RightOperandNode>
@@ -1704,11 +1744,247 @@ private:
     return e;
   }
 
+  ///
+  /// Parallel multiplication
+  ///
+public:
+  /**
+   * @brief Multiply a matrix DD with a vector or matrix DD using multiple
+   * threads.
+   * @details The sub-products below the top `parallelLevels` levels of the
+   * operands are independent of each other. They are deduplicated and
+   * distributed dynamically among `numThreads` worker threads. Each worker owns
+   * a private package, so that no synchronization of the unique tables,
+   * compute tables, or the real number table is required. The operands of a
+   * sub-product are transferred into the worker's package, multiplied there,
+   * and the results are transferred back after all workers have finished.
+   * Finally, the top levels are combined in this package.
+   *
+   * The operands are only read while the workers are running. Hence, this
+   * package must not be used concurrently. The transfers add a cost linear in
+   * the size of the operands and results, so this pays off for expensive
+   * products only.
+   * @param x The matrix DD
+   * @param y The vector or matrix DD
+   * @param numThreads The number of threads to use (0 selects the number of
+   * hardware threads)
+   * @param parallelLevels The number of top levels to split
+   * @return The product x * y (not reference counted)
+   */
+  template <class RightOperandNode>
+  Edge<RightOperandNode> multiplyParallel(const mEdge& x,
+                                          const Edge<RightOperandNode>& y,
+                                          std::size_t numThreads = 0U,
+                                          const std::size_t parallelLevels = 2U) {
+    static_assert(std::disjunction_v<std::is_same<RightOperandNode, vNode>,
+                                     std::is_same<RightOperandNode, mNode>>,
+                  "Right operand must be a vector or matrix");
+    if (numThreads == 0U) {
+      numThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    Qubit var{};
+    if (!x.isTerminal()) {
+      var = x.p->v;
+    }
+    if (!y.isTerminal() && y.p->v > var) {
+      var = y.p->v;
+    }
+    if (numThreads == 1U || parallelLevels == 0U) {
+      return cn.lookup(multiply2(x, y, var));
+    }
+
+    ParallelMultiplication<RightOperandNode> job{};
+    splitMultiplication(x, y, var, parallelLevels, job);
+    if (!job.tasks.empty()) {
+      runParallelMultiplication(job, std::min(numThreads, job.tasks.size()));
+    }
+    const auto e = combineMultiplication(x, y, var, parallelLevels, job);
+    return cn.lookup(e);
+  }
+
+private:
+  template <class RightOperandNode> struct ParallelMultiplication {
+    /// Independent sub-products with unit weights
+    std::vector<std::pair<mEdge, Edge<RightOperandNode>>> tasks{};
+    std::map<std::pair<mNode*, RightOperandNode*>, std::size_t> index{};
+    /// The results of the sub-products (in this package)
+    std::vector<Edge<RightOperandNode>> results{};
+  };
+
+  /// Get the operands of the k-th summand of entry (i, j) of x * y at level
+  /// var (mirrors multiply2)
+  template <class RightOperandNode>
+  static std::pair<mEdge, Edge<RightOperandNode>>
+  getSubOperands(const mEdge& x, const Edge<RightOperandNode>& y,
+                 const Qubit var, const std::size_t i, const std::size_t j,
+                 const std::size_t k) {
+    using REdge = Edge<RightOperandNode>;
+    constexpr std::size_t n = std::tuple_size_v<decltype(y.p->e)>;
+    constexpr std::size_t rows = RADIX;
+    constexpr std::size_t cols = n == NEDGE ? RADIX : 1U;
+
+    const auto xIdx = rows * i + k;
+    mEdge e1{};
+    if (x.p != nullptr && x.p->v == var) {
+      e1 = x.p->e[xIdx];
+    } else if (xIdx == 0 || xIdx == 3) {
+      e1 = mEdge{x.p, Complex::one()};
+    } else {
+      e1 = mEdge::zero();
+    }
+
+    const auto yIdx = j + cols * k;
+    REdge e2{};
+    if (y.p != nullptr && y.p->v == var) {
+      e2 = y.p->e[yIdx];
+    } else if (yIdx == 0 || yIdx == 3) {
+      e2 = REdge{y.p, Complex::one()};
+    } else {
+      e2 = REdge::zero();
+    }
+    return {e1, e2};
+  }
+
+  template <class RightOperandNode>
+  static bool isTrivialProduct(const mEdge& x,
+                               const Edge<RightOperandNode>& y) {
+    return x.w.exactlyZero() || y.w.exactlyZero() || x.isTerminal() ||
+           y.isTerminal();
+  }
+
+  /// Collect the sub-products below the top `depth` levels
+  template <class RightOperandNode>
+  void splitMultiplication(const mEdge& x, const Edge<RightOperandNode>& y,
+                           const Qubit var, const std::size_t depth,
+                           ParallelMultiplication<RightOperandNode>& job) {
+    if (isTrivialProduct(x, y)) {
+      return;
+    }
+    if (depth == 0U) {
+      const auto [it, inserted] =
+          job.index.try_emplace({x.p, y.p}, job.tasks.size());
+      if (inserted) {
+        job.tasks.emplace_back(mEdge{x.p, Complex::one()},
+                               Edge<RightOperandNode>{y.p, Complex::one()});
+      }
+      return;
+    }
+    constexpr std::size_t n = std::tuple_size_v<decltype(y.p->e)>;
+    constexpr std::size_t cols = n == NEDGE ? RADIX : 1U;
+    for (std::size_t i = 0U; i < RADIX; ++i) {
+      for (std::size_t j = 0U; j < cols; ++j) {
+        for (std::size_t k = 0U; k < RADIX; ++k) {
+          const auto [e1, e2] = getSubOperands(x, y, var, i, j, k);
+          splitMultiplication(e1, e2, static_cast<Qubit>(var - 1), depth - 1U,
+                              job);
+        }
+      }
+    }
+  }
+
+  template <class RightOperandNode>
+  void runParallelMultiplication(ParallelMultiplication<RightOperandNode>& job,
+                                 const std::size_t numWorkers) {
+    std::vector<std::unique_ptr<Package>> workers{};
+    workers.reserve(numWorkers);
+    for (std::size_t t = 0U; t < numWorkers; ++t) {
+      workers.emplace_back(std::make_unique<Package>(nqubits));
+    }
+    std::vector<Edge<RightOperandNode>> partial(job.tasks.size());
+    std::vector<std::exception_ptr> errors(numWorkers);
+    std::atomic<std::size_t> next{0U};
+
+    const auto work = [&](const std::size_t t) {
+      try {
+        auto& pkg = *workers[t];
+        for (auto i = next.fetch_add(1U); i < job.tasks.size();
+             i = next.fetch_add(1U)) {
+          auto [a, b] = job.tasks[i];
+          auto xt = pkg.transfer(a);
+          pkg.incRef(xt);
+          auto yt = pkg.transfer(b);
+          pkg.incRef(yt);
+          auto r = pkg.multiply(xt, yt);
+          pkg.incRef(r);
+          pkg.decRef(xt);
+          pkg.decRef(yt);
+          partial[i] = r;
+          pkg.garbageCollect();
+        }
+      } catch (...) {
+        errors[t] = std::current_exception();
+        // let the other workers drain the remaining tasks
+        next = job.tasks.size();
+      }
+    };
+    std::vector<std::thread> threads{};
+    threads.reserve(numWorkers - 1U);
+    for (std::size_t t = 1U; t < numWorkers; ++t) {
+      threads.emplace_back(work, t);
+    }
+    work(0U);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    job.results.reserve(partial.size());
+    for (auto& r : partial) {
+      job.results.emplace_back(transfer(r));
+    }
+  }
+
+  /// Combine the results of the sub-products in the top `depth` levels
+  template <class RightOperandNode>
+  CachedEdge<RightOperandNode>
+  combineMultiplication(const mEdge& x, const Edge<RightOperandNode>& y,
+                        const Qubit var, const std::size_t depth,
+                        const ParallelMultiplication<RightOperandNode>& job) {
+    using ResultEdge = CachedEdge<RightOperandNode>;
+    if (isTrivialProduct(x, y)) {
+      return multiply2(x, y, var);
+    }
+    const auto rWeight =
+        static_cast<ComplexValue>(x.w) * static_cast<ComplexValue>(y.w);
+    if (depth == 0U) {
+      const auto& r = job.results[job.index.at({x.p, y.p})];
+      return {r.p, static_cast<ComplexValue>(r.w) * rWeight};
+    }
+
+    constexpr std::size_t n = std::tuple_size_v<decltype(y.p->e)>;
+    constexpr std::size_t cols = n == NEDGE ? RADIX : 1U;
+    const auto v = static_cast<Qubit>(var - 1);
+    std::array<ResultEdge, n> edge{};
+    for (std::size_t i = 0U; i < RADIX; ++i) {
+      for (std::size_t j = 0U; j < cols; ++j) {
+        const auto idx = cols * i + j;
+        edge[idx] = ResultEdge::zero();
+        for (std::size_t k = 0U; k < RADIX; ++k) {
+          const auto [e1, e2] = getSubOperands(x, y, var, i, j, k);
+          const auto m = combineMultiplication(e1, e2, v, depth - 1U, job);
+          if (k == 0 || edge[idx].w.exactlyZero()) {
+            edge[idx] = m;
+          } else if (!m.w.exactlyZero()) {
+            edge[idx] = add2(edge[idx], m, v);
+          }
+        }
+      }
+    }
+    auto e = makeDDNode(var, edge);
+    e.w = e.w * rWeight;
+    return e;
+  }
+
   ///
   /// Inner product, fidelity, expectation value
   ///
 public:
-  ComputeTable<vNode*, vNode*, vCachedEdge, Config::CT_VEC_INNER_PROD_NBUCKET>
+  ComputeTable<vNode*, vNode*, vCachedEdge, Config::CT_VEC_INNER_PROD_NBUCKET,
+               Config::CT_VEC_INNER_PROD_NWAYS>
       vectorInnerProduct{};
 
   /**
@@ -1870,9 +2146,11 @@ public:
   /// Kronecker/tensor product
   ///
 
-  ComputeTable<vNode*, vNode*, vCachedEdge, Config::CT_VEC_KRON_NBUCKET>
+  ComputeTable<vNode*, vNode*, vCachedEdge, Config::CT_VEC_KRON_NBUCKET,
+               Config::CT_VEC_KRON_NWAYS>
       vectorKronecker{};
-  ComputeTable<mNode*, mNode*, mCachedEdge, Config::CT_MAT_KRON_NBUCKET>
+  ComputeTable<mNode*, mNode*, mCachedEdge, Config::CT_MAT_KRON_NBUCKET,
+               Config::CT_MAT_KRON_NWAYS>
       matrixKronecker{};
 
   template <class Node> [[nodiscard]] auto& getKroneckerComputeTable() {
@@ -2191,6 +2469,33 @@ public:
     return reduceAncillae(e, ancillary);
   }
 
+  ///
+  /// Gate DD cache
+  ///
+  GateDDCache<mEdge> gateDDCache{Config::GATE_DD_CACHE_SIZE};
+
+  /**
+   * @brief Lookup the DD of a gate in the gate DD cache
+   * @return A pointer to the cached DD or nullptr if the gate is not cached
+   */
+  [[nodiscard]] const mEdge* lookupGateDD(const GateDDKey& key) {
+    return gateDDCache.lookup(key);
+  }
+
+  /// Insert the DD of a gate into the gate DD cache and pin it
+  void insertGateDD(GateDDKey key, const mEdge& e) {
+    incRef(e);
+    if (const auto unpinned = gateDDCache.insert(std::move(key), e)) {
+      decRef(*unpinned);
+    }
+  }
+
+  /// Unpin and remove all DDs from the gate DD cache
+  void clearGateDDCache() {
+    gateDDCache.forEach([this](const mEdge& e) { decRef(e); });
+    gateDDCache.clear();
+  }
+
   ///
   /// Noise Operations
   ///
@@ -2580,82 +2885,96 @@ private:
   ///
 public:
   // transfers a decision diagram from another package to this package
-  template <class Node> Edge<Node> transfer(Edge<Node>& original) {
-    if (original.isTerminal()) {
+  template <class Node> Edge<Node> transfer(const Edge<Node>& original) {
+    auto top = original;
+    // the temporary density matrix flags of the root are stripped for the
+    // traversal and reapplied to the result
+    [[maybe_unused]] std::uintptr_t tempFlags = 0U;
+    if constexpr (std::is_same_v<Node, dNode>) {
+      tempFlags = dNode::getDensityMatrixTempFlags(top.p);
+      dEdge::alignDensityEdge(top);
+    }
+    if (top.isTerminal()) {
       return {original.p, cn.lookup(original.w)};
     }
 
-    // POST ORDER TRAVERSAL USING ONE STACK
-    // https://www.geeksforgeeks.org/iterative-postorder-traversal-using-stack/
-    Edge<Node> root{};
-    std::stack<Edge<Node>*> stack;
-
-    std::unordered_map<decltype(original.p), decltype(original.p)> mappedNode{};
-
-    Edge<Node>* currentEdge = &original;
+    // Post-order traversal. Every node of the original DD is mapped to an
+    // edge in this package, whose weight is the factor that remained after
+    // normalizing the rebuilt node. Like in deserialize, weights are only
+    // looked up once a node has been normalized.
     constexpr std::size_t n = std::tuple_size_v<decltype(original.p->e)>;
-    // NOLINTNEXTLINE(cppcoreguidelines-avoid-do-while)
-    do {
-      while (currentEdge != nullptr && !currentEdge->isTerminal()) {
-        for (std::size_t i = n - 1; i > 0; --i) {
-          auto& edge = currentEdge->p->e[i];
-          if (edge.isTerminal()) {
-            continue;
-          }
-          if (edge.w.approximatelyZero()) {
-            continue;
-          }
-          if (mappedNode.find(edge.p) != mappedNode.end()) {
-            continue;
+    std::unordered_map<const Node*, CachedEdge<Node>> mappedNode{};
+    std::stack<std::pair<const Node*, bool>> stack{};
+    stack.emplace(top.p, false);
+    while (!stack.empty()) {
+      auto& [node, expanded] = stack.top();
+      if (mappedNode.find(node) != mappedNode.end()) {
+        stack.pop();
+        continue;
+      }
+      if (!expanded) {
+        expanded = true;
+        const auto* const current = node;
+        for (const auto& edge : current->e) {
+          if (!edge.isTerminal() && !edge.w.approximatelyZero() &&
+              mappedNode.find(edge.p) == mappedNode.end()) {
+            stack.emplace(edge.p, false);
           }
-
-          // non-zero edge to be included
-          stack.push(&edge);
         }
-        stack.push(currentEdge);
-        currentEdge = &currentEdge->p->e[0];
+        continue;
       }
-      currentEdge = stack.top();
+      const auto* const current = node;
       stack.pop();
 
-      bool hasChild = false;
-      for (std::size_t i = 1; i < n && !hasChild; ++i) {
-        auto& edge = currentEdge->p->e[i];
-        if (edge.w.approximatelyZero()) {
-          continue;
-        }
-        if (mappedNode.find(edge.p) != mappedNode.end()) {
-          continue;
+      std::array<CachedEdge<Node>, n> edges{};
+      for (std::size_t i = 0; i < n; i++) {
+        const auto& edge = current->e[i];
+        const auto w = static_cast<ComplexValue>(edge.w);
+        if (edge.isTerminal()) {
+          edges[i] = {edge.p, w};
+        } else if (edge.w.approximatelyZero()) {
+          edges[i] = CachedEdge<Node>::zero();
+        } else {
+          const auto& mapped = mappedNode.at(edge.p);
+          edges[i] = {mapped.p, mapped.w.exactlyOne() ? w : w * mapped.w};
         }
-        hasChild = edge.p == stack.top()->p;
       }
-
-      if (hasChild) {
-        Edge<Node>* temp = stack.top();
-        stack.pop();
-        stack.push(currentEdge);
-        currentEdge = temp;
+      if constexpr (std::is_same_v<Node, dNode>) {
+        mappedNode.emplace(
+            current, makeDDNode(current->v, edges,
+                                dNode::isDensityMatrixNode(current->flags)));
       } else {
-        if (mappedNode.find(currentEdge->p) != mappedNode.end()) {
-          currentEdge = nullptr;
-          continue;
-        }
-        std::array<Edge<Node>, n> edges{};
-        for (std::size_t i = 0; i < n; i++) {
-          if (currentEdge->p->e[i].isTerminal()) {
-            edges[i].p = currentEdge->p->e[i].p;
-          } else {
-            edges[i].p = mappedNode[currentEdge->p->e[i].p];
-          }
-          edges[i].w = cn.lookup(currentEdge->p->e[i].w);
-        }
-        root = makeDDNode(currentEdge->p->v, edges);
-        mappedNode[currentEdge->p] = root.p;
-        currentEdge = nullptr;
+        mappedNode.emplace(current, makeDDNode(current->v, edges));
       }
-    } while (!stack.empty());
-    root.w = cn.lookup(original.w * root.w);
-    return root;
+    }
+    const auto& root = mappedNode.at(top.p);
+    auto result = Edge<Node>{
+        root.p, cn.lookup(static_cast<ComplexValue>(top.w) * root.w)};
+    if constexpr (std::is_same_v<Node, dNode>) {
+      result.p = reinterpret_cast<dNode*>(
+          reinterpret_cast<std::uintptr_t>(result.p) | tempFlags);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Import a DD from another package into this package
+   * @details The source DD is walked bottom-up (see transfer). Its weights are
+   * looked up in this package's complex number table and its nodes are
+   * inserted into this package's unique tables. The source package is only
+   * read. This package grows to the number of qubits of the source package if
+   * necessary. The temporary flags of a density matrix root are kept, so it
+   * has to be aligned before it is referenced (see alignDensityEdge).
+   * @param src The package the DD lives in
+   * @param root The DD (vector, matrix, or density matrix)
+   * @return The DD in this package (not referenced)
+   */
+  template <class OtherConfig, class Node>
+  Edge<Node> import(const Package<OtherConfig>& src, const Edge<Node>& root) {
+    if (src.qubits() > qubits()) {
+      resize(src.qubits());
+    }
+    return transfer(root);
   }
 
   ///
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "dd/DDDefinitions.hpp"
+#include "dd/Node.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dd {
+
+/// Measurement outcomes (bit i holds qubit i) and how often they occurred
+using Histogram = std::unordered_map<std::uint64_t, std::size_t>;
+
+/**
+ * @brief Draws computational basis measurements from a vector DD.
+ * @details On construction, every node reachable from the state is visited
+ * once and the probability of taking its 0-successor is stored in a flat side
+ * array, normalized by the squared norms of both sub-vectors. Hence, the DD
+ * neither has to be normalized nor stay alive after construction. A shot then
+ * only walks down this array, comparing one random number per level.
+ *
+ * Random numbers are derived from the seed and the shot index alone
+ * (SplitMix64), so the outcome of a shot does not depend on how many shots are
+ * drawn before it or on how the shots are split across threads.
+ */
+class Sampler {
+public:
+  /// Outcomes are packed into 64 bits
+  static constexpr std::size_t MAX_QUBITS = 64U;
+
+  /**
+   * @brief Annotate a state for sampling
+   * @param state The state (it does not need to be normalized)
+   * @throws std::invalid_argument if the state has more than MAX_QUBITS qubits
+   * @throws std::runtime_error if the state is the zero vector
+   */
+  explicit Sampler(const vEdge& state);
+
+  [[nodiscard]] std::size_t numQubits() const noexcept { return nqubits; }
+
+  /**
+   * @brief Draw a single shot
+   * @param seed The seed of the experiment
+   * @param shot The index of the shot
+   * @return The outcome (bit i holds the value of qubit i)
+   */
+  [[nodiscard]] std::uint64_t sampleShot(std::uint64_t seed,
+                                         std::uint64_t shot) const noexcept;
+
+  /**
+   * @brief Draw a number of shots
+   * @param shots The number of shots
+   * @param seed The seed of the experiment
+   * @param numThreads The number of threads to split the shots across (0 uses
+   * all hardware threads)
+   * @return The histogram of the outcomes
+   */
+  [[nodiscard]] Histogram sample(std::size_t shots, std::uint64_t seed = 0U,
+                                 std::size_t numThreads = 1U) const;
+
+  /// Format an outcome as "q(n-1) ... q(0)" (like Package::measureAll)
+  [[nodiscard]] std::string toBitString(std::uint64_t outcome) const;
+
+private:
+  struct Entry {
+    /// The probability of taking the 0-successor
+    fp p0;
+    /// Indices of the successors in `entries` (TERMINAL if none)
+    std::array<std::uint32_t, RADIX> successors;
+    /// The bit set when taking the 1-successor
+    std::uint64_t bit;
+  };
+  static constexpr auto TERMINAL = std::numeric_limits<std::uint32_t>::max();
+
+  std::vector<Entry> entries;
+  std::uint32_t root = TERMINAL;
+  std::size_t nqubits = 0U;
+};
+
+} // namespace dd
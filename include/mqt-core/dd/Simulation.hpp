@@ -1,5 +1,6 @@
 #pragma once
 
+#include "dd/Checkpoint.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/Operations.hpp"
 #include "dd/Package_fwd.hpp"
@@ -8,6 +9,7 @@
 #include <cstddef>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace dd {
 using namespace qc;
@@ -41,6 +43,168 @@ std::map<std::string, std::size_t>
 simulate(const QuantumComputation* qc, const VectorDD& in, Package<Config>& dd,
          std::size_t shots, std::size_t seed = 0U);
 
+/**
+ * @brief Simulate a circuit while periodically writing checkpoints.
+ * @details Whenever a checkpoint is due (see CheckpointConfig), the current
+ * state, the index of the next operation and the permutation are written to
+ * `checkpoint.file` in the background (see Checkpointer).
+ * @param qc The circuit to simulate (non-unitary operations are skipped)
+ * @param in The initial state
+ * @param dd The package to use
+ * @param checkpoint When and where to write checkpoints
+ * @return The final state
+ */
+template <class Config>
+VectorDD simulate(const QuantumComputation* qc, const VectorDD& in,
+                  Package<Config>& dd, const CheckpointConfig& checkpoint);
+
+/**
+ * @brief Continue a simulation from a checkpoint.
+ * @param qc The circuit the checkpoint was written for
+ * @param dd The package to use
+ * @param file The checkpoint to resume from
+ * @param checkpoint When and where to write further checkpoints
+ * @throws std::invalid_argument if the checkpoint belongs to a circuit with a
+ * different number of operations
+ * @return The final state
+ */
+template <class Config>
+VectorDD resumeSimulation(const QuantumComputation* qc, Package<Config>& dd,
+                          const std::string& file,
+                          const CheckpointConfig& checkpoint = {});
+
+/**
+ * @brief Simulate a circuit on a batch of input states
+ * @details The inputs are pushed through the circuit together. Each gate DD is
+ * built once and applied to all states before the next gate. Garbage is only
+ * collected (which clears the compute tables) after all states have passed a
+ * gate, so sub-products that several inputs share are computed once.
+ * @param qc The circuit to simulate (non-unitary operations are skipped)
+ * @param inputs The initial states
+ * @param dd The package to use
+ * @return The final states in the order of the inputs (each one referenced)
+ */
+template <class Config>
+std::vector<VectorDD> simulateBatch(const QuantumComputation* qc,
+                                    const std::vector<VectorDD>& inputs,
+                                    Package<Config>& dd);
+
+/**
+ * @brief Simulate a circuit on a batch of input states and measure each final
+ * state
+ * @details The final states are computed as in the other overload. Each of
+ * them is sampled as if it had been simulated on its own, i.e., the result for
+ * an input equals `simulate(qc, input, dd, shots, seed)` for a non-zero seed.
+ * @throws std::invalid_argument if the circuit is dynamic
+ * @return The measurement counts in the order of the inputs
+ */
+template <class Config>
+std::vector<std::map<std::string, std::size_t>>
+simulateBatch(const QuantumComputation* qc,
+              const std::vector<VectorDD>& inputs, Package<Config>& dd,
+              std::size_t shots, std::size_t seed = 0U);
+
+/**
+ * @brief Remove the edges that contribute the least to a state
+ * @details The contribution of an edge is the probability mass of all
+ * amplitudes whose paths pass through it, i.e., the product of the mass
+ * flowing into its source node, its squared magnitude and the squared norm of
+ * the sub-vector it points to. Edges are removed in order of increasing
+ * contribution as long as their accumulated contribution does not exceed
+ * `budget`. Afterwards, the state is renormalized.
+ * @param state The state to approximate (its reference is transferred to the
+ * result)
+ * @param budget The maximum probability mass to remove
+ * @param dd The package to use
+ * @return The fidelity of the approximated state w.r.t. the original state
+ */
+template <class Config>
+fp approximate(VectorDD& state, fp budget, Package<Config>& dd);
+
+/**
+ * @brief Simulate a circuit while approximating the state whenever it grows
+ * too large.
+ * @details Whenever the state DD has more than `nodeThreshold` nodes after
+ * applying a gate, it is approximated such that the fidelity of this step is
+ * at least `stepFidelity` (see approximate). If the approximation cannot bring
+ * the DD below the threshold, the threshold is raised to twice the size of the
+ * approximated DD so that the budget is not spent after every single gate.
+ * @param qc The circuit to simulate (measurements are not supported)
+ * @param in The initial state
+ * @param dd The package to use
+ * @param nodeThreshold The size of the DD that triggers an approximation
+ * @param stepFidelity The minimum fidelity of a single approximation
+ * @param fidelity Set to the product of the fidelities of all approximations
+ * @return The approximated final state
+ */
+template <class Config>
+VectorDD simulateApproximately(const QuantumComputation* qc,
+                               const VectorDD& in, Package<Config>& dd,
+                               std::size_t nodeThreshold, fp stepFidelity,
+                               fp& fidelity);
+
+/// Tuning knobs of simulateHybrid
+struct HybridSimulationConfig {
+  /// Switch to a dense vector once the DD has more than this fraction of 2^n
+  /// nodes
+  fp denseRatio = 0.25;
+  /// Switch back to a DD once the DD rebuilt from the dense vector has at most
+  /// this fraction of 2^n nodes
+  fp sparseRatio = 0.01;
+  /// The number of gates applied to the dense vector between two checks
+  /// whether the state has become compressible again
+  std::size_t checkInterval = 16U;
+  /// The largest number of qubits for which a dense vector is allocated
+  std::size_t maxDenseQubits = 28U;
+};
+
+/// What happened during simulateHybrid
+struct HybridSimulationStatistics {
+  /// The number of gates applied to the dense vector
+  std::size_t denseGates = 0U;
+  /// The number of switches from the DD to the dense vector
+  std::size_t toDense = 0U;
+  /// The number of switches from the dense vector back to a DD (not counting
+  /// the final conversion of the result)
+  std::size_t toDD = 0U;
+};
+
+/**
+ * @brief Multiply a dense state vector by a matrix DD
+ * @details The matrix is traversed once. Identity levels (skipped nodes) and
+ * terminals are applied block-wise, so the innermost loop is a scaled
+ * addition of contiguous blocks that the compiler vectorizes. Zero edges are
+ * skipped together with the block they would touch.
+ * @param op The matrix (acting on `nqubits` qubits, identity above its root)
+ * @param nqubits The number of qubits of the state
+ * @param in The state vector (of length 2^nqubits)
+ * @param out Set to op * in
+ */
+void applyToDense(const mEdge& op, std::size_t nqubits, const CVec& in,
+                  CVec& out);
+
+/**
+ * @brief Simulate a circuit on a DD while it is compact and on a dense vector
+ * while it is not.
+ * @details After each gate, the size of the DD is compared against 2^n. Once
+ * it exceeds `denseRatio` of that, the state is exported to a dense vector
+ * (see exportDenseVector) and the following gates are applied with applyToDense. Every `checkInterval`
+ * gates, a DD is rebuilt from the dense vector via makeStateFromVector. If it
+ * has at most `sparseRatio` * 2^n nodes, simulation continues on that DD.
+ * Otherwise, it is discarded.
+ * @param qc The circuit to simulate (non-unitary operations are skipped)
+ * @param in The initial state
+ * @param dd The package to use
+ * @param config When to switch between both representations
+ * @param stats Set to what happened during the simulation
+ * @return The final state
+ */
+template <class Config>
+VectorDD simulateHybrid(const QuantumComputation* qc, const VectorDD& in,
+                        Package<Config>& dd,
+                        const HybridSimulationConfig& config,
+                        HybridSimulationStatistics& stats);
+
 template <class Config>
 void extractProbabilityVector(const QuantumComputation* qc, const VectorDD& in,
                               dd::SparsePVec& probVector, Package<Config>& dd);
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "dd/Node.hpp"
 #include "dd/statistics/TableStatistics.hpp"
 
 #include <array>
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 
 namespace dd {
@@ -13,6 +15,8 @@ namespace dd {
 /// \tparam OperandType type of the operation's operand
 /// \tparam ResultType type of the operation's result
 /// \tparam NBUCKET number of hash buckets to use (has to be a power of two)
+/// \note Entries referencing vector or matrix nodes are validated against the
+/// generations of these nodes (see NodeGeneration and ComputeTable).
 template <class OperandType, class ResultType, std::size_t NBUCKET = 32768>
 class UnaryComputeTable {
 public:
@@ -24,8 +28,14 @@ public:
   struct Entry {
     OperandType operand;
     ResultType result;
+    std::uint8_t operandGeneration;
+    std::uint8_t resultGeneration;
   };
 
+  static constexpr bool TRACKS_GENERATIONS =
+      NodeGeneration<OperandType>::TRACKED &&
+      NodeGeneration<ResultType>::TRACKED;
+
   static constexpr size_t MASK = NBUCKET - 1;
 
   /// Get a reference to the table
@@ -46,7 +56,8 @@ public:
       stats.trackInsert();
       valid.set(key);
     }
-    table[key] = {operand, result};
+    table[key] = {operand, result, NodeGeneration<OperandType>::of(operand),
+                  NodeGeneration<ResultType>::of(result)};
   }
 
   ResultType* lookup(const OperandType& operand) {
@@ -62,6 +73,15 @@ public:
     if (entry.operand != operand) {
       return result;
     }
+    if constexpr (TRACKS_GENERATIONS) {
+      if (entry.operandGeneration != NodeGeneration<OperandType>::of(operand) ||
+          entry.resultGeneration !=
+              NodeGeneration<ResultType>::of(entry.result)) {
+        valid.reset(key);
+        --stats.numEntries;
+        return result;
+      }
+    }
 
     ++stats.hits;
     return &entry.result;
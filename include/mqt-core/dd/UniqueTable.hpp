@@ -16,6 +16,7 @@
 #include <nlohmann/json.hpp>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace dd {
@@ -194,6 +195,10 @@ public:
     p->next = tables[v][key];
     tables[v][key] = p;
     stats[v].trackInsert();
+    if (incremental) {
+      // new nodes are the most likely ones to die young
+      candidates.emplace_back(p);
+    }
 
     return p;
   }
@@ -230,6 +235,9 @@ public:
     const auto dec = ::dd::decRef(p);
     if (dec && p->ref == 0U) {
       --stats[p->v].numActiveEntries;
+      if (incremental) {
+        candidates.emplace_back(p);
+      }
     }
     return dec;
   }
@@ -238,16 +246,98 @@ public:
     return getNumEntries() >= gcLimit;
   }
 
+  /**
+   * @brief Enable or disable incremental garbage collection.
+   * @details By default, garbage collection sweeps all buckets of all
+   * variables. In incremental mode, the table instead records candidates for
+   * collection, i.e., nodes that have been inserted and nodes whose reference
+   * count dropped to zero, and garbage collection only inspects these. Since
+   * every node with a reference count of zero has been recorded at some point,
+   * a collection that processes all candidates frees the same nodes as a full
+   * sweep.
+   * @param enable Whether to collect incrementally.
+   * @param sliceSize If non-zero, a single non-forced garbage collection
+   * inspects at most this many candidates, which bounds the pause time. The
+   * remaining candidates are inspected by subsequent collections.
+   */
+  void setIncrementalCollection(const bool enable,
+                                const std::size_t sliceSize = 0U) {
+    incremental = enable;
+    gcSliceSize = sliceSize;
+    candidates.clear();
+    // nodes inserted before have not been recorded
+    fullSweepPending = enable && getNumEntries() > 0U;
+  }
+
+  /// Get the number of recorded candidates for incremental garbage collection
+  [[nodiscard]] std::size_t getNumCollectionCandidates() const noexcept {
+    return candidates.size();
+  }
+
   std::size_t garbageCollect(bool force = false) {
     const std::size_t numEntriesBefore = getNumEntries();
     if ((!force && numEntriesBefore < gcLimit) || numEntriesBefore == 0U) {
       return 0U;
     }
 
+    for (auto& stat : stats) {
+      ++stat.gcRuns;
+    }
+    if (incremental && !fullSweepPending) {
+      collectCandidates(force);
+    } else {
+      sweep();
+    }
+
+    // The garbage collection limit changes dynamically depending on the number
+    // of remaining (active) nodes. If it were not changed, garbage collection
+    // would run through the complete table on each successive call once the
+    // number of remaining entries reaches the garbage collection limit. It is
+    // increased whenever the number of remaining entries is rather close to the
+    // garbage collection threshold and decreased if the number of remaining
+    // entries is much lower than the current limit. Pending candidates of a
+    // time-sliced collection keep the limit so that the next call continues.
+    const auto numEntries = getNumEntries();
+    if (candidates.empty() && numEntries > gcLimit / 10 * 9) {
+      gcLimit = numEntries + initialGCLimit;
+    }
+    return numEntriesBefore - numEntries;
+  }
+
+  void clear() {
+    // clear unique table buckets
+    for (auto& table : tables) {
+      for (auto& bucket : table) {
+        bucket = nullptr;
+      }
+    }
+    gcLimit = initialGCLimit;
+    candidates.clear();
+    fullSweepPending = false;
+    for (auto& stat : stats) {
+      stat.reset();
+    }
+  };
+
+  /**
+   * @brief Check whether the generation of a reclaimed node wrapped around
+   * @details Resets the flag. Compute table entries referencing nodes of this
+   * table cannot be validated via generations (see NodeGeneration) after a
+   * wrap-around and have to be cleared.
+   * @return whether a generation wrapped around since the last call
+   */
+  [[nodiscard]] bool consumeGenerationWrap() noexcept {
+    return std::exchange(generationWrapped, false);
+  }
+
+private:
+  /// Collect all nodes with a reference count of zero by sweeping all buckets
+  void sweep() {
+    candidates.clear();
+    fullSweepPending = false;
     std::size_t v = 0U;
     for (auto& table : tables) {
       auto& stat = stats[v];
-      ++stat.gcRuns;
       for (auto& bucket : table) {
         Node* p = bucket;
         Node* lastp = nullptr;
@@ -259,7 +349,7 @@ public:
             } else {
               lastp->next = next;
             }
-            memoryManager->returnEntry(p);
+            reclaim(p);
             p = next;
             --stat.numEntries;
           } else {
@@ -271,34 +361,53 @@ public:
       stat.numActiveEntries = stat.numEntries;
       ++v;
     }
+  }
 
-    // The garbage collection limit changes dynamically depending on the number
-    // of remaining (active) nodes. If it were not changed, garbage collection
-    // would run through the complete table on each successive call once the
-    // number of remaining entries reaches the garbage collection limit. It is
-    // increased whenever the number of remaining entries is rather close to the
-    // garbage collection threshold and decreased if the number of remaining
-    // entries is much lower than the current limit.
-    const auto numEntries = getNumEntries();
-    if (numEntries > gcLimit / 10 * 9) {
-      gcLimit = numEntries + initialGCLimit;
+  /**
+   * @brief Collect the recorded candidates with a reference count of zero
+   * @param all Whether to process all candidates regardless of the slice size
+   */
+  void collectCandidates(const bool all) {
+    // a node may have been recorded multiple times
+    std::sort(candidates.begin(), candidates.end(), std::less<Node*>{});
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    auto budget = candidates.size();
+    if (!all && gcSliceSize != 0U) {
+      budget = std::min(budget, gcSliceSize);
+    }
+    for (; budget > 0U; --budget) {
+      auto* p = candidates.back();
+      candidates.pop_back();
+      // revived nodes are recorded again once they become dead
+      if (p->ref != 0U) {
+        continue;
+      }
+      const auto v = p->v;
+      if (unlink(p)) {
+        reclaim(p);
+        --stats[v].numEntries;
+      }
     }
-    return numEntriesBefore - numEntries;
   }
 
-  void clear() {
-    // clear unique table buckets
-    for (auto& table : tables) {
-      for (auto& bucket : table) {
-        bucket = nullptr;
-      }
+  /// Remove a node from its bucket. Returns false if it is not in the table.
+  bool unlink(const Node* p) noexcept {
+    if (p->v >= nvars) {
+      return false;
     }
-    gcLimit = initialGCLimit;
-    for (auto& stat : stats) {
-      stat.reset();
+    for (Node** link = &tables[p->v][hash(p)]; *link != nullptr;
+         link = &(*link)->next) {
+      if (*link == p) {
+        *link = p->next;
+        return true;
+      }
     }
-  };
+    return false;
+  }
 
+public:
   void print() {
     auto q = nvars - 1U;
     for (auto it = tables.rbegin(); it != tables.rend(); ++it) {
@@ -346,6 +455,32 @@ private:
   /// A pointer to the memory manager for the nodes stored in the table.
   MemoryManager<Node>* memoryManager;
 
+  /// Whether a generation counter wrapped around since the last check
+  bool generationWrapped = false;
+
+  /// Whether garbage collection only inspects the recorded candidates
+  bool incremental = false;
+  /// Maximum number of candidates inspected per non-forced collection
+  std::size_t gcSliceSize = 0U;
+  /// Nodes that possibly have a reference count of zero
+  std::vector<Node*> candidates{};
+  /// Whether the next collection has to sweep the whole table
+  bool fullSweepPending = false;
+
+  /**
+   * @brief Return a collected node to the memory manager
+   * @details Bumps the node's generation so that compute table entries
+   * referencing it become stale. Since a node is collected at most once per
+   * garbage collection run, a wrap-around is always detected by the next
+   * consumeGenerationWrap() after the run.
+   */
+  void reclaim(Node* p) noexcept {
+    if (++p->generation == 0U) {
+      generationWrapped = true;
+    }
+    memoryManager->returnEntry(p);
+  }
+
   /// A collection of statistics
   std::vector<UniqueTableStatistics> stats{nvars};
 
@@ -26,6 +26,12 @@ template <typename T> struct MemoryManagerStatistics : public Statistics {
   std::size_t peakNumUsed = 0U;
   /// The peak number of entries available for reuse
   std::size_t peakNumAvailableForReuse = 0U;
+  /// The number of bytes currently reserved for chunks
+  std::size_t numReservedBytes = 0U;
+  /// The peak number of bytes reserved for chunks
+  std::size_t peakNumReservedBytes = 0U;
+  /// The number of chunks returned to the heap or the operating system
+  std::size_t numReleasedChunks = 0U;
 
   static constexpr auto ENTRY_MEMORY_MIB =
       static_cast<double>(sizeof(T)) / static_cast<double>(1ULL << 20U);
@@ -48,6 +54,9 @@ template <typename T> struct MemoryManagerStatistics : public Statistics {
   /// Get an estimate for the peak used memory in MiB
   [[nodiscard]] double getPeakUsedMemoryMiB() const noexcept;
 
+  /// Get the memory currently reserved for chunks in MiB
+  [[nodiscard]] double getReservedMemoryMiB() const noexcept;
+
   /// Track newly used entries (from chunks)
   void trackUsedEntries(std::size_t numEntries = 1U) noexcept;
 
@@ -57,6 +66,13 @@ template <typename T> struct MemoryManagerStatistics : public Statistics {
   /// Track a new available entry for reuse
   void trackReturnedEntry() noexcept;
 
+  /// Track a newly reserved chunk of memory
+  void trackReservedBytes(std::size_t numBytes) noexcept;
+
+  /// Track a released chunk whose entries were all available for reuse
+  void trackReleasedChunk(std::size_t numEntries,
+                          std::size_t numBytes) noexcept;
+
   /// Reset all statistics (except for the peak values)
   void reset() noexcept override;
 
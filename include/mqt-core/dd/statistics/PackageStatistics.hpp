@@ -153,6 +153,7 @@ getStatistics(Package<Config>* package,
       package->stochasticNoiseOperationCache.getStats().json();
   computeTables["density_noise_operations"] =
       package->densityNoise.getStats().json();
+  computeTables["gate_dd_cache"] = package->gateDDCache.getStats().json();
 
   j["active_memory_mib"] = computeActiveMemoryMiB(package);
   j["peak_memory_mib"] = computePeakMemoryMiB(package);
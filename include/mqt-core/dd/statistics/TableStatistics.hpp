@@ -27,6 +27,11 @@ struct TableStatistics : public Statistics {
   /// The number of inserts
   std::size_t inserts = 0U;
 
+  /// The number of lookups at the time of the last checkpoint
+  std::size_t checkpointLookups = 0U;
+  /// The number of successful lookups at the time of the last checkpoint
+  std::size_t checkpointHits = 0U;
+
   /// Track a new insert
   void trackInsert() noexcept;
 
@@ -40,6 +45,31 @@ struct TableStatistics : public Statistics {
    */
   [[nodiscard]] double hitRatio() const noexcept;
 
+  /**
+   * @brief Remember the current lookup and hit counts
+   * @details Subsequent calls to hitRatioSinceCheckpoint() only consider
+   * lookups after this point, which makes it possible to compare the hit rate
+   * of individual phases of a computation (e.g., single gates of a circuit or
+   * different table configurations).
+   */
+  void checkpoint() noexcept;
+
+  /**
+   * @brief Get the hit ratio of the lookups since the last checkpoint.
+   * @returns The hit ratio since the last checkpoint.
+   */
+  [[nodiscard]] double hitRatioSinceCheckpoint() const noexcept;
+
+  /**
+   * @brief Get the change of the hit ratio caused by the lookups since the
+   * last checkpoint.
+   * @details Positive values indicate that the recent lookups hit more often
+   * than the ones before the checkpoint.
+   * @returns The difference between the hit ratio since the checkpoint and the
+   * hit ratio before it.
+   */
+  [[nodiscard]] double hitRatioDelta() const noexcept;
+
   /**
    * @brief Get the collision ratio of the table.
    * @details A collision occurs when the hash function maps two different
@@ -14,12 +14,14 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <numeric>
 #include <optional>
 #include <random>
+#include <set>
 #include <sstream>
 #include <string>
 #include <unordered_set>
@@ -39,9 +41,15 @@ public:
       typename std::vector<std::unique_ptr<Operation>>::reverse_iterator;
   using const_reverse_iterator =
       typename std::vector<std::unique_ptr<Operation>>::const_reverse_iterator;
+  /// Receives the operations of a circuit that is imported in streaming mode
+  using OperationSink = std::function<void(std::unique_ptr<Operation>)>;
 
 protected:
   std::vector<std::unique_ptr<Operation>> ops;
+  /// If set, appended operations are passed here instead of being stored
+  OperationSink operationSink{};
+  /// The qubits acted on by operations that were passed to the sink
+  std::set<Qubit> streamedQubits{};
   std::size_t nqubits = 0;
   std::size_t nclassics = 0;
   std::size_t nancillae = 0;
@@ -73,6 +81,9 @@ protected:
   void readQCGateDescriptions(std::istream& is, int line,
                               std::map<std::string, Qubit>& varMap);
 
+  /// Store an operation or pass it to the operation sink (if set)
+  void append(std::unique_ptr<Operation> op);
+
   template <class RegisterType>
   static void printSortedRegisters(const RegisterMap<RegisterType>& regmap,
                                    const std::string& identifier,
@@ -253,9 +264,10 @@ public:
   QuantumComputation(QuantumComputation&& qc) noexcept = default;
   QuantumComputation& operator=(QuantumComputation&& qc) noexcept = default;
   QuantumComputation(const QuantumComputation& qc)
-      : nqubits(qc.nqubits), nclassics(qc.nclassics), nancillae(qc.nancillae),
-        name(qc.name), qregs(qc.qregs), cregs(qc.cregs), ancregs(qc.ancregs),
-        mt(qc.mt), seed(qc.seed), globalPhase(qc.globalPhase),
+      : streamedQubits(qc.streamedQubits), nqubits(qc.nqubits),
+        nclassics(qc.nclassics), nancillae(qc.nancillae), name(qc.name),
+        qregs(qc.qregs), cregs(qc.cregs), ancregs(qc.ancregs), mt(qc.mt),
+        seed(qc.seed), globalPhase(qc.globalPhase),
         occurringVariables(qc.occurringVariables),
         initialLayout(qc.initialLayout),
         outputPermutation(qc.outputPermutation), ancillary(qc.ancillary),
@@ -282,6 +294,7 @@ public:
       outputPermutation = qc.outputPermutation;
       ancillary = qc.ancillary;
       garbage = qc.garbage;
+      streamedQubits = qc.streamedQubits;
 
       ops.clear();
       ops.reserve(qc.ops.size());
@@ -725,6 +738,22 @@ public:
   void import(const std::string& filename);
   void import(const std::string& filename, Format format);
   void import(std::istream& is, Format format);
+
+  /**
+   * @brief Import a circuit without materializing its operations
+   * @details The meta information of the circuit (registers, initial layout,
+   * output permutation, ancillary and garbage qubits) is imported into this
+   * object as usual. However, every operation is passed to `sink` as soon as
+   * the parser creates it instead of being stored in the circuit. The sink is
+   * invoked on the calling thread and in circuit order. Qubits acted on by the
+   * streamed operations are not considered idle. Measurements are streamed as
+   * well, but they do not contribute to the output permutation.
+   * @param filename The file to import (the format is derived from the
+   * extension)
+   * @param sink The callback receiving the operations
+   */
+  void importStreaming(const std::string& filename, OperationSink sink);
+  void importStreaming(std::istream& is, Format format, OperationSink sink);
   void initializeIOMapping();
   // append measurements to the end of the circuit according to the tracked
   // output permutation
@@ -881,6 +910,7 @@ public:
     ancregs.clear();
     initialLayout.clear();
     outputPermutation.clear();
+    streamedQubits.clear();
   }
 
   /**
@@ -946,22 +976,22 @@ public:
       std::cerr << op.getName() << std::endl;
     }
 
-    ops.push_back(std::make_unique<T>(op));
+    append(std::make_unique<T>(op));
   }
 
   // NOLINTNEXTLINE(readability-identifier-naming)
   template <class T, class... Args> void emplace_back(Args&&... args) {
-    ops.emplace_back(std::make_unique<T>(std::forward<Args>(args)...));
+    append(std::make_unique<T>(std::forward<Args>(args)...));
   }
 
   // NOLINTNEXTLINE(readability-identifier-naming)
   template <class T> void emplace_back(std::unique_ptr<T>& op) {
-    ops.emplace_back(std::move(op));
+    append(std::move(op));
   }
 
   // NOLINTNEXTLINE(readability-identifier-naming)
   template <class T> void emplace_back(std::unique_ptr<T>&& op) {
-    ops.emplace_back(std::move(op));
+    append(std::move(op));
   }
 
   template <class T> iterator insert(const_iterator pos, T&& op) {
@@ -1340,7 +1340,8 @@ struct DSU {
 
   /**
    * @brief Merge two blocks together.
-   * @details The smaller block is merged into the larger block.
+   * @details The block that started earlier is merged into the one that
+   * started later.
    * @param block1 first block
    * @param block2 second block
    */
@@ -1352,8 +1353,13 @@ struct DSU {
     }
     assert(currentBlockOperations[parent1] != nullptr);
     assert(currentBlockOperations[parent2] != nullptr);
-    if (currentBlockOperations[parent1]->size() <
-        currentBlockOperations[parent2]->size()) {
+    // The merged block is placed at the position of the block that started
+    // later in the circuit. Moving the operations of the other block back is
+    // safe, since no operation in between acts on its qubits. Moving them
+    // forward is not, since a previously finalized block might act on them.
+    const auto* pos1 = currentBlockInCircuit[parent1];
+    const auto* pos2 = currentBlockInCircuit[parent2];
+    if (pos1 == nullptr || (pos2 != nullptr && pos2 > pos1)) {
       std::swap(parent1, parent2);
     }
     parent[parent2] = parent1;
@@ -0,0 +1,269 @@
+#include "dd/ColumnarSerialization.hpp"
+
+#include "Definitions.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Node.hpp"
+#include "dd/RealNumber.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MQT_CORE_DD_HAS_MMAP 1
+#endif
+
+namespace dd {
+namespace {
+constexpr std::array<char, 8> MAGIC{'M', 'Q', 'T', 'D', 'D', 'C', 'O', 'L'};
+
+struct Header {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t radix;
+  std::uint64_t numNodes;
+  std::uint64_t numWeights;
+  std::uint32_t root;
+  std::uint32_t rootWeight;
+};
+static_assert(sizeof(Header) % 8U == 0U);
+
+constexpr std::size_t padded(const std::size_t bytes) noexcept {
+  return (bytes + 7U) / 8U * 8U;
+}
+
+template <class T>
+void writeColumn(std::ostream& os, const std::vector<T>& column) {
+  const auto bytes = column.size() * sizeof(T);
+  os.write(reinterpret_cast<const char*>(column.data()),
+           static_cast<std::streamsize>(bytes));
+  constexpr std::array<char, 8> zeros{};
+  os.write(zeros.data(), static_cast<std::streamsize>(padded(bytes) - bytes));
+}
+
+template <class Node>
+void writeColumnar(const Edge<Node>& root, std::ostream& os) {
+  constexpr auto N = std::tuple_size_v<decltype(Node::e)>;
+
+  // collect all nodes and sort them by level, which puts every successor
+  // before its parents
+  std::vector<const Node*> nodes{};
+  std::unordered_map<const Node*, std::uint32_t> index{};
+  if (!root.isTerminal()) {
+    std::vector<const Node*> stack{root.p};
+    index.emplace(root.p, 0U);
+    while (!stack.empty()) {
+      const auto* p = stack.back();
+      stack.pop_back();
+      nodes.emplace_back(p);
+      for (const auto& e : p->e) {
+        if (!e.isTerminal() && index.emplace(e.p, 0U).second) {
+          stack.emplace_back(e.p);
+        }
+      }
+    }
+  }
+  if (nodes.size() >= ColumnarView::TERMINAL) {
+    throw std::invalid_argument("Too many nodes for the columnar format.");
+  }
+  std::stable_sort(nodes.begin(), nodes.end(),
+                   [](const Node* a, const Node* b) { return a->v < b->v; });
+  for (std::size_t i = 0U; i < nodes.size(); ++i) {
+    index[nodes[i]] = static_cast<std::uint32_t>(i);
+  }
+
+  // equal weights share their real numbers in the package, so the pointers
+  // identify them
+  std::vector<fp> weights{};
+  std::unordered_map<std::pair<const RealNumber*, const RealNumber*>,
+                     std::uint32_t,
+                     qc::PairHash<const RealNumber*, const RealNumber*>>
+      pool{};
+  pool.reserve((N * nodes.size()) + 1U);
+  const auto weightIndex = [&](const Complex& w) {
+    const auto [it, inserted] = pool.emplace(
+        std::pair<const RealNumber*, const RealNumber*>{w.r, w.i},
+        static_cast<std::uint32_t>(weights.size() / 2U));
+    if (inserted) {
+      weights.emplace_back(RealNumber::val(w.r));
+      weights.emplace_back(RealNumber::val(w.i));
+    }
+    return it->second;
+  };
+  const auto successorIndex = [&](const Edge<Node>& e) {
+    return e.isTerminal() ? ColumnarView::TERMINAL : index.at(e.p);
+  };
+
+  std::vector<std::uint32_t> successors{};
+  std::vector<std::uint32_t> edgeWeights{};
+  std::vector<Qubit> levels{};
+  successors.reserve(N * nodes.size());
+  edgeWeights.reserve(N * nodes.size());
+  levels.reserve(nodes.size());
+  for (const auto* p : nodes) {
+    for (const auto& e : p->e) {
+      successors.emplace_back(successorIndex(e));
+      edgeWeights.emplace_back(weightIndex(e.w));
+    }
+    levels.emplace_back(p->v);
+  }
+
+  Header header{};
+  header.magic = MAGIC;
+  header.version = COLUMNAR_VERSION;
+  header.radix = static_cast<std::uint32_t>(N);
+  header.numNodes = nodes.size();
+  header.root = successorIndex(root);
+  header.rootWeight = weightIndex(root.w);
+  header.numWeights = weights.size() / 2U;
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  writeColumn(os, weights);
+  writeColumn(os, successors);
+  writeColumn(os, edgeWeights);
+  writeColumn(os, levels);
+}
+} // namespace
+
+void serializeColumnar(const vEdge& root, std::ostream& os) {
+  writeColumnar(root, os);
+}
+
+void serializeColumnar(const mEdge& root, std::ostream& os) {
+  writeColumnar(root, os);
+}
+
+ColumnarView parseColumnar(const char* data, const std::size_t size) {
+  if (reinterpret_cast<std::uintptr_t>(data) % alignof(fp) != 0U) {
+    throw std::runtime_error("Serialized DD must be 8-byte aligned.");
+  }
+  Header header{};
+  if (size < sizeof(header)) {
+    throw std::runtime_error("Serialized DD is truncated.");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != MAGIC) {
+    throw std::runtime_error("Data is not a columnar serialized DD.");
+  }
+  if (header.version != COLUMNAR_VERSION) {
+    throw std::runtime_error(
+        "Wrong version of columnar serialization. version of file: " +
+        std::to_string(header.version) +
+        "; current version: " + std::to_string(COLUMNAR_VERSION));
+  }
+  if (header.radix != RADIX && header.radix != NEDGE) {
+    throw std::runtime_error("Serialized DD has an invalid radix.");
+  }
+  if (header.numNodes >= ColumnarView::TERMINAL ||
+      header.numWeights >= ColumnarView::TERMINAL) {
+    throw std::runtime_error("Serialized DD is too large.");
+  }
+
+  ColumnarView view{};
+  view.radix = header.radix;
+  view.numNodes = header.numNodes;
+  view.numWeights = header.numWeights;
+  view.root = header.root;
+  view.rootWeight = header.rootWeight;
+  const auto entries = view.radix * view.numNodes;
+  auto offset = sizeof(header);
+  const auto column = [&](const std::size_t bytes) {
+    if (size < offset || size - offset < padded(bytes)) {
+      throw std::runtime_error("Serialized DD is truncated.");
+    }
+    const auto* begin = data + offset;
+    offset += padded(bytes);
+    return begin;
+  };
+  view.weights = reinterpret_cast<const fp*>(
+      column(2U * view.numWeights * sizeof(fp)));
+  view.successors = reinterpret_cast<const std::uint32_t*>(
+      column(entries * sizeof(std::uint32_t)));
+  view.edgeWeights = reinterpret_cast<const std::uint32_t*>(
+      column(entries * sizeof(std::uint32_t)));
+  view.levels =
+      reinterpret_cast<const Qubit*>(column(view.numNodes * sizeof(Qubit)));
+
+  const auto checkEdge = [&](const std::uint32_t successor,
+                             const std::uint32_t weight, const std::size_t node,
+                             const std::size_t level) {
+    if (weight >= view.numWeights) {
+      throw std::runtime_error("Serialized DD has an invalid weight index.");
+    }
+    if (successor != ColumnarView::TERMINAL &&
+        (successor >= node || view.levels[successor] >= level)) {
+      throw std::runtime_error("Serialized DD has an invalid node index.");
+    }
+  };
+  for (std::size_t i = 0U; i < view.numNodes; ++i) {
+    for (std::size_t j = 0U; j < view.radix; ++j) {
+      checkEdge(view.successors[(i * view.radix) + j],
+                view.edgeWeights[(i * view.radix) + j], i, view.levels[i]);
+    }
+  }
+  // the root may point to any node
+  checkEdge(view.root, view.rootWeight, view.numNodes,
+            std::numeric_limits<std::size_t>::max());
+  return view;
+}
+
+MappedFile::MappedFile(const std::string& file) {
+#ifdef MQT_CORE_DD_HAS_MMAP
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  const auto fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::invalid_argument("Cannot open serialized file: " + file);
+  }
+  struct stat info{};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::invalid_argument("Cannot open serialized file: " + file);
+  }
+  length = static_cast<std::size_t>(info.st_size);
+  if (length > 0U) {
+    auto* mem = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mem != MAP_FAILED) {
+      begin = static_cast<const char*>(mem);
+      mapped = true;
+    }
+  }
+  ::close(fd);
+  if (mapped || length == 0U) {
+    return;
+  }
+#endif
+  std::ifstream ifs(file, std::ios::binary | std::ios::ate);
+  if (!ifs.good()) {
+    throw std::invalid_argument("Cannot open serialized file: " + file);
+  }
+  buffer.resize(static_cast<std::size_t>(ifs.tellg()));
+  ifs.seekg(0);
+  ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  begin = buffer.data();
+  length = buffer.size();
+}
+
+MappedFile::~MappedFile() {
+#ifdef MQT_CORE_DD_HAS_MMAP
+  if (mapped) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    ::munmap(const_cast<char*>(begin), length);
+  }
+#endif
+}
+
+} // namespace dd
@@ -0,0 +1,254 @@
+#include "dd/ConcurrentRealNumberUniqueTable.hpp"
+
+#include "dd/DDDefinitions.hpp"
+#include "dd/MemoryManager.hpp"
+#include "dd/RealNumber.hpp"
+#include "dd/RealNumberUniqueTable.hpp"
+#include "dd/statistics/UniqueTableStatistics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace dd {
+
+ConcurrentRealNumberUniqueTable::ConcurrentRealNumberUniqueTable(
+    MemoryManager<RealNumber>& manager, const std::size_t initialGCLim)
+    : memoryManager(&manager), initialGCLimit(initialGCLim) {
+  // add 1/2 to the table and increase its ref count (so that it is not
+  // collected)
+  lookupNonNegative(0.5L)->ref++;
+}
+
+std::int64_t ConcurrentRealNumberUniqueTable::hash(const fp val) noexcept {
+  // both tables use the same number of buckets
+  return RealNumberUniqueTable::hash(val);
+}
+
+RealNumber* ConcurrentRealNumberUniqueTable::lookup(const fp val) {
+  // if the value is close enough to zero, return the zero entry (avoiding -0.0)
+  if (RealNumber::approximatelyZero(val)) {
+    return &constants::zero;
+  }
+  if (const auto sign = std::signbit(val); sign) {
+    return RealNumber::getNegativePointer(lookupNonNegative(std::abs(val)));
+  }
+  return lookupNonNegative(val);
+}
+
+void ConcurrentRealNumberUniqueTable::incRef(RealNumber* num) noexcept {
+  const auto inc = RealNumber::incRef(num);
+  if (inc && RealNumber::refCount(num) == 1U) {
+    ++numActiveEntries;
+    peakNumActiveEntries = std::max(peakNumActiveEntries, numActiveEntries);
+  }
+}
+
+void ConcurrentRealNumberUniqueTable::decRef(RealNumber* num) noexcept {
+  const auto dec = RealNumber::decRef(num);
+  if (dec && RealNumber::refCount(num) == 0U) {
+    --numActiveEntries;
+  }
+}
+
+RealNumber* ConcurrentRealNumberUniqueTable::lookupNonNegative(const fp val) {
+  assert(!std::isnan(val));
+  assert(val > 0);
+
+  if (RealNumber::approximatelyEquals(val, 1.0)) {
+    return &constants::one;
+  }
+
+  if (RealNumber::approximatelyEquals(val, SQRT2_2)) {
+    return &constants::sqrt2over2;
+  }
+
+  lookups.fetch_add(1U, std::memory_order_relaxed);
+  const auto lowerKey = hash(val - RealNumber::eps);
+  const auto upperKey = hash(val + RealNumber::eps);
+  const auto key = hash(val);
+
+  if (upperKey == lowerKey) {
+    return findOrInsert(key, key, key, val);
+  }
+
+  // Values on both sides of a border may match each other. Serializing these
+  // insertions per border guarantees that only one of them is inserted.
+  const std::lock_guard lock{
+      borderLocks[static_cast<std::size_t>(upperKey) % NBORDERLOCKS]};
+  return findOrInsert(key, lowerKey, upperKey, val);
+}
+
+RealNumber* ConcurrentRealNumberUniqueTable::findOrInsert(
+    const std::int64_t key, const std::int64_t lowerKey,
+    const std::int64_t upperKey, const fp val) {
+  // the tolerance is much smaller than the bucket width
+  assert(upperKey - lowerKey <= 1);
+  const auto lower = static_cast<std::size_t>(lowerKey);
+  const auto numBuckets = static_cast<std::size_t>(upperKey - lowerKey) + 1U;
+  const auto home = static_cast<std::size_t>(key) - lower;
+
+  std::array<RealNumber*, 2> heads{};
+  std::array<RealNumber*, 2> seen{};
+  for (std::size_t b = 0U; b < numBuckets; ++b) {
+    heads[b] = table[lower + b].load(std::memory_order_acquire);
+  }
+
+  RealNumber* entry = nullptr;
+  while (true) {
+    // only entries published since the last pass have to be inspected
+    RealNumber* best = nullptr;
+    for (std::size_t b = 0U; b < numBuckets; ++b) {
+      findClosest(heads[b], seen[b], val, best);
+      seen[b] = heads[b];
+    }
+    if (best != nullptr) {
+      hits.fetch_add(1U, std::memory_order_relaxed);
+      if (entry != nullptr) {
+        release(entry);
+      }
+      return best;
+    }
+
+    if (entry == nullptr) {
+      entry = allocate(val);
+    }
+    entry->next = heads[home];
+    if (table[lower + home].compare_exchange_weak(
+            heads[home], entry, std::memory_order_release,
+            std::memory_order_acquire)) {
+      const auto entries = numEntries.fetch_add(1U) + 1U;
+      inserts.fetch_add(1U, std::memory_order_relaxed);
+      auto peak = peakNumEntries.load(std::memory_order_relaxed);
+      while (peak < entries && !peakNumEntries.compare_exchange_weak(
+                                   peak, entries, std::memory_order_relaxed)) {
+      }
+      return entry;
+    }
+    // another thread changed the bucket, heads[home] now holds the new head
+    collisions.fetch_add(1U, std::memory_order_relaxed);
+    for (std::size_t b = 0U; b < numBuckets; ++b) {
+      if (b != home) {
+        heads[b] = table[lower + b].load(std::memory_order_acquire);
+      }
+    }
+  }
+}
+
+void ConcurrentRealNumberUniqueTable::findClosest(RealNumber* head,
+                                                  const RealNumber* stop,
+                                                  const fp val,
+                                                  RealNumber*& best) noexcept {
+  for (auto* p = head; p != stop; p = p->next) {
+    if (!RealNumber::approximatelyEquals(val, p->value)) {
+      continue;
+    }
+    if (best == nullptr ||
+        std::abs(p->value - val) < std::abs(best->value - val)) {
+      best = p;
+    }
+  }
+}
+
+RealNumber* ConcurrentRealNumberUniqueTable::allocate(const fp val) {
+  RealNumber* entry = nullptr;
+  {
+    const std::lock_guard lock{memoryMutex};
+    entry = memoryManager->get();
+  }
+  entry->value = val;
+  entry->ref = 0U;
+  return entry;
+}
+
+void ConcurrentRealNumberUniqueTable::release(RealNumber* entry) {
+  const std::lock_guard lock{memoryMutex};
+  memoryManager->returnEntry(entry);
+}
+
+UniqueTableStatistics
+ConcurrentRealNumberUniqueTable::getStats() const noexcept {
+  UniqueTableStatistics stats{};
+  stats.entrySize = sizeof(Bucket);
+  stats.numBuckets = NBUCKET;
+  stats.numEntries = numEntries.load(std::memory_order_relaxed);
+  stats.peakNumEntries = peakNumEntries.load(std::memory_order_relaxed);
+  stats.lookups = lookups.load(std::memory_order_relaxed);
+  stats.hits = hits.load(std::memory_order_relaxed);
+  stats.collisions = collisions.load(std::memory_order_relaxed);
+  stats.inserts = inserts.load(std::memory_order_relaxed);
+  stats.numActiveEntries = numActiveEntries;
+  stats.peakNumActiveEntries = peakNumActiveEntries;
+  stats.gcRuns = gcRuns;
+  return stats;
+}
+
+bool ConcurrentRealNumberUniqueTable::possiblyNeedsCollection() const noexcept {
+  return getNumEntries() >= gcLimit;
+}
+
+std::size_t
+ConcurrentRealNumberUniqueTable::garbageCollect(const bool force) noexcept {
+  // the table always contains at least 0.5
+  const auto entryCountBefore = getNumEntries();
+  if ((!force && !possiblyNeedsCollection()) || entryCountBefore <= 1) {
+    return 0;
+  }
+
+  ++gcRuns;
+  std::size_t remaining = 0U;
+  for (auto& bucket : table) {
+    RealNumber* head = nullptr;
+    RealNumber* last = nullptr;
+    for (auto* p = bucket.load(std::memory_order_relaxed); p != nullptr;) {
+      auto* next = p->next;
+      if (p->ref == 0) {
+        memoryManager->returnEntry(p);
+      } else {
+        if (last == nullptr) {
+          head = p;
+        } else {
+          last->next = p;
+        }
+        last = p;
+        ++remaining;
+      }
+      p = next;
+    }
+    if (last != nullptr) {
+      last->next = nullptr;
+    }
+    bucket.store(head, std::memory_order_release);
+  }
+  numEntries.store(remaining, std::memory_order_relaxed);
+
+  // @see RealNumberUniqueTable::garbageCollect
+  if (remaining > gcLimit / 10 * 9) {
+    gcLimit = remaining + initialGCLimit;
+  } else if (remaining < gcLimit / 128) {
+    gcLimit /= 2;
+  }
+  numActiveEntries = remaining;
+  return entryCountBefore - remaining;
+}
+
+void ConcurrentRealNumberUniqueTable::clear() noexcept {
+  for (auto& bucket : table) {
+    bucket.store(nullptr, std::memory_order_relaxed);
+  }
+  gcLimit = initialGCLimit;
+  numEntries = 0U;
+  lookups = 0U;
+  hits = 0U;
+  collisions = 0U;
+  inserts = 0U;
+  numActiveEntries = 0U;
+  gcRuns = 0U;
+}
+
+} // namespace dd
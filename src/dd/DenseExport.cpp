@@ -0,0 +1,380 @@
+#include "dd/DenseExport.hpp"
+
+#include "dd/DDDefinitions.hpp"
+#include "dd/Edge.hpp"
+#include "dd/Node.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+#define MQT_CORE_DD_HAS_MMAP 1
+#endif
+
+namespace dd {
+
+DenseBuffer::DenseBuffer(const std::size_t size)
+    : entries(static_cast<std::complex<fp>*>(
+          ::operator new(std::max<std::size_t>(size, 1U) *
+                         sizeof(std::complex<fp>)))),
+      count(size), bytes(std::max<std::size_t>(size, 1U) *
+                         sizeof(std::complex<fp>)) {}
+
+DenseBuffer::DenseBuffer(const std::size_t size, const std::string& file)
+    : count(size),
+      bytes(std::max<std::size_t>(size, 1U) * sizeof(std::complex<fp>)) {
+#ifdef MQT_CORE_DD_HAS_MMAP
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  const auto fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open " + file + ".");
+  }
+  if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Could not resize " + file + ".");
+  }
+  auto* mem =
+      ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // the mapping stays valid after the descriptor is closed
+  ::close(fd);
+  if (mem == MAP_FAILED) {
+    throw std::runtime_error("Could not map " + file + ".");
+  }
+  entries = static_cast<std::complex<fp>*>(mem);
+  isMapped = true;
+#else
+  throw std::runtime_error("Memory-mapped buffers are not supported on this "
+                           "platform (requested for " +
+                           file + ").");
+#endif
+}
+
+DenseBuffer::~DenseBuffer() { release(); }
+
+DenseBuffer::DenseBuffer(DenseBuffer&& other) noexcept
+    : entries(std::exchange(other.entries, nullptr)),
+      count(std::exchange(other.count, 0U)),
+      bytes(std::exchange(other.bytes, 0U)),
+      isMapped(std::exchange(other.isMapped, false)) {}
+
+DenseBuffer& DenseBuffer::operator=(DenseBuffer&& other) noexcept {
+  if (this != &other) {
+    release();
+    entries = std::exchange(other.entries, nullptr);
+    count = std::exchange(other.count, 0U);
+    bytes = std::exchange(other.bytes, 0U);
+    isMapped = std::exchange(other.isMapped, false);
+  }
+  return *this;
+}
+
+void DenseBuffer::release() noexcept {
+  if (entries == nullptr) {
+    return;
+  }
+#ifdef MQT_CORE_DD_HAS_MMAP
+  if (isMapped) {
+    ::munmap(entries, bytes);
+    entries = nullptr;
+    return;
+  }
+#endif
+  ::operator delete(entries);
+  entries = nullptr;
+}
+
+namespace {
+using Amplitude = std::complex<fp>;
+
+/// Blocks of nodes below this level are cheaper to recompute than to look up
+constexpr std::size_t MIN_COPY_LEVEL = 2U;
+
+/**
+ * @brief dst[i] = s * src[i] for i < n
+ * @details std::complex<fp> is layout-compatible with fp[2]. Spelling out the
+ * product avoids the NaN handling of complex multiplication, which keeps the
+ * compiler from vectorizing this loop.
+ */
+void scaleCopy(const Amplitude* src, Amplitude* dst, const std::size_t n,
+               const Amplitude s) {
+  const auto* xs = reinterpret_cast<const fp*>(src);
+  auto* ys = reinterpret_cast<fp*>(dst);
+  const auto sr = s.real();
+  const auto si = s.imag();
+  for (std::size_t i = 0U; i < 2U * n; i += 2U) {
+    ys[i] = sr * xs[i] - si * xs[i + 1U];
+    ys[i + 1U] = sr * xs[i + 1U] + si * xs[i];
+  }
+}
+
+/// A square block (a contiguous range for vectors) of the output
+struct Block {
+  std::size_t level;
+  std::size_t row;
+  std::size_t col;
+};
+
+template <class Node> struct Task {
+  Edge<Node> e;
+  /// The accumulated weight of the path to the block (including e.w)
+  Amplitude amp;
+  Block block;
+};
+
+/**
+ * @brief Writes blocks of the output while remembering where each node was
+ * written first
+ * @details Every thread uses its own writer, so the blocks it copies from
+ * have been completed by the same thread.
+ */
+template <class Node> class Writer {
+  static constexpr bool IS_VECTOR = std::is_same_v<Node, vNode>;
+
+  /// Where a node was written first and with which weight
+  struct Written {
+    Amplitude amp;
+    Block block;
+  };
+
+public:
+  Writer(Amplitude* output, const std::size_t dimension)
+      : out(output), stride(dimension) {}
+
+  void write(const Edge<Node>& e, const Amplitude amp, const Block& block) {
+    const auto dim = std::size_t{1} << block.level;
+    if (e.w.exactlyZero() || amp == Amplitude{}) {
+      clear(block);
+      return;
+    }
+    if (e.isTerminal()) {
+      if constexpr (IS_VECTOR) {
+        out[block.row] = amp;
+      } else {
+        // a scaled identity
+        clear(block);
+        for (std::size_t i = 0U; i < dim; ++i) {
+          out[((block.row + i) * stride) + block.col + i] = amp;
+        }
+      }
+      return;
+    }
+
+    const auto half = dim / 2U;
+    const auto sub = block.level - 1U;
+    if constexpr (!IS_VECTOR) {
+      if (static_cast<std::size_t>(e.p->v) + 1U < block.level) {
+        // a skipped identity level
+        write(e, amp, {sub, block.row, block.col});
+        write(e, amp, {sub, block.row + half, block.col + half});
+        clear({sub, block.row, block.col + half});
+        clear({sub, block.row + half, block.col});
+        return;
+      }
+    }
+
+    // a node referenced by exactly one edge is not reached twice (unless it
+    // is not reference counted at all, which leaves its count at zero)
+    const auto memoize = block.level >= MIN_COPY_LEVEL && e.p->ref != 1U;
+    if (memoize) {
+      if (const auto it = written.find(e.p); it != written.end()) {
+        copy(it->second, amp, block);
+        return;
+      }
+    }
+    for (std::size_t i = 0U; i < e.p->e.size(); ++i) {
+      const auto& child = e.p->e[i];
+      const auto childAmp = child.w.exactlyZero()
+                                ? Amplitude{}
+                                : amp * static_cast<Amplitude>(child.w);
+      if constexpr (IS_VECTOR) {
+        write(child, childAmp, {sub, block.row + (i * half), 0U});
+      } else {
+        write(child, childAmp,
+              {sub, block.row + ((i / RADIX) * half),
+               block.col + ((i % RADIX) * half)});
+      }
+    }
+    if (memoize) {
+      written.emplace(e.p, Written{amp, block});
+    }
+  }
+
+private:
+  void clear(const Block& block) {
+    const auto dim = std::size_t{1} << block.level;
+    if constexpr (IS_VECTOR) {
+      std::fill_n(out + block.row, dim, Amplitude{});
+    } else {
+      for (std::size_t i = 0U; i < dim; ++i) {
+        std::fill_n(out + ((block.row + i) * stride) + block.col, dim,
+                    Amplitude{});
+      }
+    }
+  }
+
+  void copy(const Written& from, const Amplitude amp, const Block& block) {
+    const auto dim = std::size_t{1} << block.level;
+    const auto scale = amp / from.amp;
+    if constexpr (IS_VECTOR) {
+      scaleCopy(out + from.block.row, out + block.row, dim, scale);
+    } else {
+      for (std::size_t i = 0U; i < dim; ++i) {
+        scaleCopy(out + ((from.block.row + i) * stride) + from.block.col,
+                  out + ((block.row + i) * stride) + block.col, dim, scale);
+      }
+    }
+  }
+
+  Amplitude* out;
+  /// The length of a row of the output (matrices only)
+  std::size_t stride;
+  std::unordered_map<const Node*, Written> written;
+};
+
+/// Split the top `depth` levels into independent tasks
+template <class Node>
+void split(const Edge<Node>& e, const Amplitude amp, const Block& block,
+           const std::size_t depth, std::vector<Task<Node>>& tasks) {
+  if (depth == 0U || block.level == 0U || e.w.exactlyZero() ||
+      e.isTerminal()) {
+    tasks.push_back({e, amp, block});
+    return;
+  }
+  const auto half = std::size_t{1} << (block.level - 1U);
+  const auto sub = block.level - 1U;
+  if constexpr (std::is_same_v<Node, vNode>) {
+    for (std::size_t i = 0U; i < RADIX; ++i) {
+      const auto& child = e.p->e[i];
+      split(child, amp * static_cast<Amplitude>(child.w),
+            {sub, block.row + (i * half), 0U}, depth - 1U, tasks);
+    }
+  } else {
+    if (static_cast<std::size_t>(e.p->v) + 1U < block.level) {
+      split(e, amp, {sub, block.row, block.col}, depth - 1U, tasks);
+      split(e, amp, {sub, block.row + half, block.col + half}, depth - 1U,
+            tasks);
+      split(Edge<Node>::zero(), {}, {sub, block.row, block.col + half},
+            depth - 1U, tasks);
+      split(Edge<Node>::zero(), {}, {sub, block.row + half, block.col},
+            depth - 1U, tasks);
+      return;
+    }
+    for (std::size_t i = 0U; i < NEDGE; ++i) {
+      const auto& child = e.p->e[i];
+      split(child, amp * static_cast<Amplitude>(child.w),
+            {sub, block.row + ((i / RADIX) * half),
+             block.col + ((i % RADIX) * half)},
+            depth - 1U, tasks);
+    }
+  }
+}
+
+template <class Node>
+void exportDense(const Edge<Node>& e, const std::size_t nqubits,
+                 Amplitude* out, std::size_t numThreads) {
+  if (numThreads == 0U) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  // about four tasks per thread to balance unevenly sized blocks
+  std::size_t depth = 0U;
+  while (numThreads > 1U && depth < nqubits &&
+         (std::size_t{1} << depth) < 4U * numThreads) {
+    ++depth;
+  }
+
+  std::vector<Task<Node>> tasks{};
+  split(e, static_cast<Amplitude>(e.w), {nqubits, 0U, 0U}, depth, tasks);
+  numThreads = std::min(numThreads, tasks.size());
+
+  const auto stride = std::size_t{1} << nqubits;
+  std::vector<std::exception_ptr> errors(numThreads);
+  std::atomic<std::size_t> next{0U};
+  const auto work = [&](const std::size_t t) {
+    try {
+      Writer<Node> writer(out, stride);
+      for (auto i = next.fetch_add(1U); i < tasks.size();
+           i = next.fetch_add(1U)) {
+        writer.write(tasks[i].e, tasks[i].amp, tasks[i].block);
+      }
+    } catch (...) {
+      errors[t] = std::current_exception();
+      // let the other threads drain the remaining tasks
+      next = tasks.size();
+    }
+  };
+  std::vector<std::thread> threads{};
+  threads.reserve(numThreads - 1U);
+  for (std::size_t t = 1U; t < numThreads; ++t) {
+    threads.emplace_back(work, t);
+  }
+  work(0U);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+} // namespace
+
+void exportDenseVector(const vEdge& e, const std::size_t nqubits,
+                       std::complex<fp>* out, const std::size_t numThreads) {
+  if (nqubits >= 64U) {
+    throw std::invalid_argument("Too many qubits for a dense vector.");
+  }
+  if (e.isTerminal() ? nqubits != 0U
+                     : static_cast<std::size_t>(e.p->v) + 1U != nqubits) {
+    throw std::invalid_argument("Vector does not act on " +
+                                std::to_string(nqubits) + " qubits.");
+  }
+  exportDense(e, nqubits, out, numThreads);
+}
+
+void exportDenseMatrix(const mEdge& e, const std::size_t nqubits,
+                       std::complex<fp>* out, const std::size_t numThreads) {
+  if (nqubits >= 32U) {
+    throw std::invalid_argument("Too many qubits for a dense matrix.");
+  }
+  if (!e.isTerminal() && static_cast<std::size_t>(e.p->v) >= nqubits) {
+    throw std::invalid_argument("Matrix acts on more than " +
+                                std::to_string(nqubits) + " qubits.");
+  }
+  exportDense(e, nqubits, out, numThreads);
+}
+
+DenseBuffer getDenseVector(const vEdge& e, const std::size_t nqubits,
+                           const std::size_t numThreads,
+                           const std::string& file) {
+  const auto size = nqubits < 64U ? std::size_t{1} << nqubits : 0U;
+  auto buffer = file.empty() ? DenseBuffer(size) : DenseBuffer(size, file);
+  exportDenseVector(e, nqubits, buffer.data(), numThreads);
+  return buffer;
+}
+
+DenseBuffer getDenseMatrix(const mEdge& e, const std::size_t nqubits,
+                           const std::size_t numThreads,
+                           const std::string& file) {
+  const auto size = nqubits < 32U ? std::size_t{1} << (2U * nqubits) : 0U;
+  auto buffer = file.empty() ? DenseBuffer(size) : DenseBuffer(size, file);
+  exportDenseMatrix(e, nqubits, buffer.data(), numThreads);
+  return buffer;
+}
+
+} // namespace dd
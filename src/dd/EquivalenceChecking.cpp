@@ -0,0 +1,382 @@
+#include "dd/EquivalenceChecking.hpp"
+
+#include "Definitions.hpp"
+#include "dd/ComplexNumbers.hpp"
+#include "dd/DDCompletement.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/DDLinear.hpp"
+#include "dd/DDReorder.hpp"
+#include "dd/GateMatrixDefinitions.hpp"
+#include "dd/Operations.hpp"
+#include "dd/Package.hpp"
+#include "ir/Permutation.hpp"
+#include "ir/QuantumComputation.hpp"
+#include "ir/operations/ClassicControlledOperation.hpp"
+#include "ir/operations/CompoundOperation.hpp"
+#include "ir/operations/OpType.hpp"
+#include "ir/operations/Operation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stack>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace dd {
+namespace {
+/// Marks levels that are only touched by the final post-processing
+constexpr auto UNTIL_END = std::numeric_limits<std::size_t>::max();
+
+/**
+ * @brief Mark the levels the DD of an operation acts on
+ * @details Mirrors the permutation handling of getDD, i.e., SWAPs only update
+ * the permutation if one is given.
+ */
+void collectLevels(const qc::Operation* op, qc::Permutation& permutation,
+                   std::vector<bool>& levels) {
+  const auto type = op->getType();
+  if (!permutation.empty() && type == qc::SWAP && !op->isControlled()) {
+    const auto& targets = op->getTargets();
+    std::swap(permutation.at(targets[0U]), permutation.at(targets[1U]));
+    return;
+  }
+  if (type == qc::Barrier || type == qc::GPhase) {
+    return;
+  }
+  if (const auto* compoundOp = dynamic_cast<const qc::CompoundOperation*>(op)) {
+    for (const auto& operation : *compoundOp) {
+      collectLevels(operation.get(), permutation, levels);
+    }
+    return;
+  }
+  if (const auto* classicOp =
+          dynamic_cast<const qc::ClassicControlledOperation*>(op)) {
+    collectLevels(classicOp->getOperation(), permutation, levels);
+    return;
+  }
+  for (const auto q : op->getUsedQubits()) {
+    levels.at(permutation.empty() ? q : permutation.at(q)) = true;
+  }
+}
+
+/// The state of one of the two circuits during the check
+struct CircuitState {
+  explicit CircuitState(const qc::QuantumComputation* circuit)
+      : qc(circuit), permutation(circuit->initialLayout) {
+    const auto nq = qc->getNqubits();
+    lastUse.resize(nq, 0U);
+    auto perm = permutation;
+    std::vector<bool> levels(nq);
+    for (std::size_t i = 0U; i < qc->size(); ++i) {
+      std::fill(levels.begin(), levels.end(), false);
+      collectLevels(qc->at(i).get(), perm, levels);
+      for (std::size_t l = 0U; l < nq; ++l) {
+        if (levels[l]) {
+          lastUse[l] = i + 1U;
+        }
+      }
+    }
+    // the post-processing acts on the levels whose permutation is corrected
+    // as well as on the ancillary and garbage qubits
+    for (const auto& [q, goal] : qc->outputPermutation) {
+      if (const auto it = perm.find(q);
+          it != perm.end() && it->second != goal) {
+        lastUse.at(it->second) = UNTIL_END;
+        lastUse.at(goal) = UNTIL_END;
+      }
+    }
+    for (std::size_t l = 0U; l < nq; ++l) {
+      if ((l < qc->ancillary.size() && qc->ancillary[l]) ||
+          (l < qc->garbage.size() && qc->garbage[l])) {
+        lastUse[l] = UNTIL_END;
+      }
+    }
+  }
+
+  [[nodiscard]] bool done() const { return applied == qc->size(); }
+  [[nodiscard]] double progress() const {
+    return static_cast<double>(applied) / static_cast<double>(qc->size());
+  }
+  [[nodiscard]] const qc::Operation* next() const {
+    return qc->at(applied).get();
+  }
+
+  const qc::QuantumComputation* qc;
+  /// Maps the qubits of the circuit to the current levels of the DD
+  qc::Permutation permutation;
+  /// The number of operations after which an (original) level is not touched
+  /// anymore
+  std::vector<std::size_t> lastUse{};
+  std::size_t applied = 0U;
+};
+
+/**
+ * @brief Check whether a DD acts as the identity on the given levels
+ * @details Every node on these levels has to be of the form [x 0 0 x] (up to
+ * the tolerance of the unique tables).
+ */
+bool actsAsIdentityOn(const mEdge& e, const std::vector<bool>& levels,
+                      const fp tol) {
+  const auto lowest = static_cast<Qubit>(
+      std::find(levels.begin(), levels.end(), true) - levels.begin());
+  std::unordered_set<const mNode*> visited{};
+  std::stack<const mNode*> stack{};
+  if (!e.isTerminal() && e.p->v >= lowest) {
+    stack.emplace(e.p);
+  }
+  while (!stack.empty()) {
+    const auto* p = stack.top();
+    stack.pop();
+    if (!visited.emplace(p).second) {
+      continue;
+    }
+    if (levels[p->v]) {
+      const auto& es = p->e;
+      if (ComplexNumbers::mag2(es[1U].w) > tol ||
+          ComplexNumbers::mag2(es[2U].w) > tol || es[0U].p != es[3U].p ||
+          !es[0U].w.approximatelyEquals(es[3U].w)) {
+        return false;
+      }
+    }
+    for (const auto& child : p->e) {
+      if (!child.isTerminal() && child.p->v >= lowest) {
+        stack.emplace(child.p);
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Determine a variable order for a DD via sifting
+ * @details The reordering kernels rewrite nodes in place and require a DD
+ * without skipped levels. Hence, the DD is sifted in a scratch package.
+ * @return The level that should be moved to each level
+ */
+template <class Config>
+std::vector<Qubit> siftedOrder(mEdge e, const std::size_t nq) {
+  auto scratch = std::make_unique<Package<Config>>(nq);
+  auto copy = scratch->transfer(e);
+  scratch->incRef(copy);
+  levelCompleteSkipped(copy, scratch.get());
+
+  qc::QuantumComputation qtc(nq);
+  reorderSelect(copy, scratch.get(), &qtc, SCHEME_SIFTING);
+
+  std::vector<Qubit> order(nq);
+  for (const auto& [level, var] : qtc.outputPermutation) {
+    order.at(level) = static_cast<Qubit>(var);
+  }
+  return order;
+}
+
+/// Tracks the levels of the intermediate DD while reordering it
+template <class Config> class LevelOrder {
+public:
+  LevelOrder(Package<Config>& package, const std::size_t nq,
+             CircuitState& left, CircuitState& right)
+      : dd(&package), states{&left, &right}, order(nq) {
+    std::iota(order.begin(), order.end(), 0U);
+  }
+
+  /// The current level of an original level
+  [[nodiscard]] Qubit levelOf(const Qubit original) const {
+    return static_cast<Qubit>(
+        std::find(order.begin(), order.end(), original) - order.begin());
+  }
+
+  /// The original level at each current level
+  [[nodiscard]] const std::vector<Qubit>& get() const { return order; }
+
+  /**
+   * @brief Establish the given order
+   * @param e The DD to reorder (its reference is transferred to the result)
+   * @param target The original level that should end up at each level
+   */
+  mEdge establish(mEdge e, const std::vector<Qubit>& target) {
+    for (Qubit l = 0U; l < target.size(); ++l) {
+      if (const auto k = levelOf(target[l]); k != l) {
+        e = swap(e, l, k);
+      }
+    }
+    return e;
+  }
+
+  /// Restore the original order
+  mEdge restore(mEdge e) {
+    std::vector<Qubit> identity(order.size());
+    std::iota(identity.begin(), identity.end(), 0U);
+    return establish(e, identity);
+  }
+
+private:
+  Package<Config>* dd;
+  std::array<CircuitState*, 2U> states;
+  /// The original level at each current level
+  std::vector<Qubit> order;
+
+  /// Exchange two levels of the DD by conjugating it with a SWAP gate
+  mEdge swap(mEdge e, const Qubit a, const Qubit b) {
+    const auto swapDD = dd->makeTwoQubitGateDD(SWAP_MAT, a, b);
+    auto tmp = dd->multiply(dd->multiply(swapDD, e), swapDD);
+    dd->incRef(tmp);
+    dd->decRef(e);
+    dd->garbageCollect();
+
+    std::swap(order[a], order[b]);
+    for (auto* state : states) {
+      for (auto& [q, level] : state->permutation) {
+        if (level == a) {
+          level = b;
+        } else if (level == b) {
+          level = a;
+        }
+      }
+    }
+    return tmp;
+  }
+};
+} // namespace
+
+template <class Config>
+EquivalenceCheckingResult
+checkEquivalence(const qc::QuantumComputation* qc1,
+                 const qc::QuantumComputation* qc2, Package<Config>& dd,
+                 const EquivalenceCheckingConfig& config) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto nq = qc1->getNqubits();
+  if (qc2->getNqubits() != nq) {
+    throw std::invalid_argument(
+        "Both circuits have to act on the same number of qubits.");
+  }
+
+  EquivalenceCheckingResult result{};
+  const auto finish = [&]() {
+    result.peakActiveNodes = dd.mUniqueTable.getPeakNumActiveEntries();
+    result.runtime = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    return result;
+  };
+
+  CircuitState left{qc1};
+  CircuitState right{qc2};
+  LevelOrder<Config> levels{dd, nq, left, right};
+
+  auto e = dd.makeIdent();
+  e = dd.reduceAncillae(e, qc1->ancillary);
+  e = dd.reduceAncillae(e, qc2->ancillary, false);
+  result.peakNodes = e.size();
+
+  std::vector<bool> finished(nq, false);
+  auto reorderLimit = config.reorderThreshold;
+  while (!left.done() || !right.done()) {
+    // apply both circuits in proportion to their sizes, so that gates that
+    // cancel each other meet early
+    const auto applyLeft =
+        right.done() ||
+        (!left.done() && left.progress() <= right.progress());
+
+    auto& state = applyLeft ? left : right;
+    const auto next =
+        applyLeft
+            ? dd.multiply(getDD(left.next(), dd, left.permutation), e)
+            : dd.multiply(e, getInverseDD(right.next(), dd, right.permutation));
+    ++state.applied;
+    dd.incRef(next);
+    dd.decRef(e);
+    e = next;
+    dd.garbageCollect();
+    const auto size = e.size();
+    result.peakNodes = std::max(result.peakNodes, size);
+
+    if (config.earlyExit) {
+      // check the levels that are not touched anymore
+      std::vector<bool> check(nq, false);
+      bool any = false;
+      for (Qubit l = 0U; l < nq; ++l) {
+        if (!finished[l] && left.applied >= left.lastUse[l] &&
+            right.applied >= right.lastUse[l]) {
+          finished[l] = true;
+          check[levels.levelOf(l)] = true;
+          any = true;
+        }
+      }
+      if (any && !actsAsIdentityOn(e, check, config.tolerance)) {
+        dd.decRef(e);
+        dd.garbageCollect();
+        result.earlyExit = true;
+        result.appliedGates1 = left.applied;
+        result.appliedGates2 = right.applied;
+        return finish();
+      }
+    }
+
+    if (config.reorder && size > reorderLimit) {
+      const auto previous = levels.get();
+      auto target = siftedOrder<Config>(e, nq);
+      for (auto& l : target) {
+        l = previous[l];
+      }
+      auto reordered = e;
+      dd.incRef(reordered);
+      reordered = levels.establish(reordered, target);
+      if (reordered.size() < size) {
+        dd.decRef(e);
+        e = reordered;
+        ++result.reorderings;
+      } else {
+        dd.decRef(levels.establish(reordered, previous));
+      }
+      dd.garbageCollect();
+      reorderLimit = std::max(
+          config.reorderThreshold,
+          static_cast<std::size_t>(config.reorderGrowthFactor *
+                                   static_cast<double>(e.size())));
+    }
+  }
+  result.appliedGates1 = left.applied;
+  result.appliedGates2 = right.applied;
+
+  // undo the reordering and correct the permutations
+  e = levels.restore(e);
+  changePermutation(e, left.permutation, qc1->outputPermutation, dd);
+  changePermutation(e, right.permutation, qc2->outputPermutation, dd, false);
+  e = dd.reduceGarbage(e, qc1->garbage);
+  e = dd.reduceGarbage(e, qc2->garbage, false);
+
+  std::vector<bool> garbage(nq, false);
+  for (std::size_t q = 0U; q < nq; ++q) {
+    garbage[q] = (q < qc1->garbage.size() && qc1->garbage[q]) ||
+                 (q < qc2->garbage.size() && qc2->garbage[q]);
+  }
+  if (!e.w.exactlyZero() &&
+      dd.isCloseToIdentity(e, config.tolerance, garbage)) {
+    result.equivalence = e.w.approximatelyEquals(Complex::one())
+                             ? EquivalenceCriterion::Equivalent
+                             : EquivalenceCriterion::EquivalentUpToGlobalPhase;
+  }
+  dd.decRef(e);
+  dd.garbageCollect();
+  return finish();
+}
+
+template EquivalenceCheckingResult
+checkEquivalence(const qc::QuantumComputation* qc1,
+                 const qc::QuantumComputation* qc2,
+                 Package<DDPackageConfig>& dd,
+                 const EquivalenceCheckingConfig& config);
+template EquivalenceCheckingResult
+checkEquivalence(const qc::QuantumComputation* qc1,
+                 const qc::QuantumComputation* qc2,
+                 UnitarySimulatorDDPackage& dd,
+                 const EquivalenceCheckingConfig& config);
+
+} // namespace dd
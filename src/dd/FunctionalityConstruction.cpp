@@ -1,32 +1,429 @@
 #include "dd/FunctionalityConstruction.hpp"
 
+#include "Definitions.hpp"
+#include "circuit_optimizer/CircuitOptimizer.hpp"
+#include "dd/Checkpoint.hpp"
 #include "dd/Package.hpp"
+#include "ir/Permutation.hpp"
 #include "ir/QuantumComputation.hpp"
+#include "ir/operations/ClassicControlledOperation.hpp"
+#include "ir/operations/CompoundOperation.hpp"
+#include "ir/operations/OpType.hpp"
+#include "ir/operations/Operation.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <stack>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace dd {
+namespace {
+/// Apply the permutation updates performed by getDD without building the DD
+void updatePermutation(const Operation* op, Permutation& permutation) {
+  if (permutation.empty()) {
+    return;
+  }
+  if (op->getType() == SWAP && !op->isControlled()) {
+    const auto& targets = op->getTargets();
+    std::swap(permutation.at(targets[0U]), permutation.at(targets[1U]));
+    return;
+  }
+  if (const auto* compoundOp = dynamic_cast<const CompoundOperation*>(op)) {
+    for (const auto& operation : *compoundOp) {
+      updatePermutation(operation.get(), permutation);
+    }
+    return;
+  }
+  if (const auto* classicOp =
+          dynamic_cast<const ClassicControlledOperation*>(op)) {
+    updatePermutation(classicOp->getOperation(), permutation);
+  }
+}
+
+/**
+ * @brief Multiply the operations from index `first` onwards into `e`
+ * @param e The functionality of the first `first` operations (referenced)
+ * @param permutation The permutation after the first `first` operations
+ */
+template <class Config>
+MatrixDD buildFunctionalityFrom(const QuantumComputation* qc,
+                                Package<Config>& dd, MatrixDD e,
+                                Permutation permutation,
+                                const std::size_t first,
+                                const CheckpointConfig& checkpoint) {
+  Checkpointer<Config, mNode> checkpointer(dd, checkpoint, qc->size());
+  for (auto i = first; i < qc->size(); ++i) {
+    auto tmp = dd.multiply(getDD(qc->at(i).get(), dd, permutation), e);
+
+    dd.incRef(tmp);
+    dd.decRef(e);
+    e = tmp;
+
+    dd.garbageCollect();
+    checkpointer.step(e, i + 1U, permutation);
+  }
+  checkpointer.finish();
+
+  // correct permutation if necessary
+  changePermutation(e, permutation, qc->outputPermutation, dd);
+  e = dd.reduceAncillae(e, qc->ancillary);
+  e = dd.reduceGarbage(e, qc->garbage);
+
+  return e;
+}
+
+/// Run `work(t)` for t in [0, numWorkers) on separate threads
+template <class F> void runWorkers(const std::size_t numWorkers, F&& work) {
+  std::vector<std::exception_ptr> errors(numWorkers);
+  const auto guarded = [&](const std::size_t t) {
+    try {
+      work(t);
+    } catch (...) {
+      errors[t] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads{};
+  threads.reserve(numWorkers);
+  for (std::size_t t = 1U; t < numWorkers; ++t) {
+    threads.emplace_back(guarded, t);
+  }
+  guarded(0U);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+/// An operation handed from the parser to the builder
+struct StreamedOperation {
+  std::unique_ptr<Operation> op;
+  /// The number of qubits of the circuit when the operation was parsed
+  std::size_t nqubits = 0U;
+  /// The initial layout of the circuit (only set for the first operation)
+  std::optional<Permutation> layout{};
+};
+
+/// Thrown on the parsing thread when the building thread gave up
+struct StreamingCancelled {};
+
+/// A bounded queue handing operations from the parsing to the building thread
+class OperationQueue {
+public:
+  explicit OperationQueue(const std::size_t cap)
+      : capacity(std::max<std::size_t>(cap, 1U)) {}
+
+  /// @return false if the consumer has cancelled the queue
+  bool push(StreamedOperation item) {
+    std::unique_lock lock{mutex};
+    notFull.wait(lock, [this] { return items.size() < capacity || cancelled; });
+    if (cancelled) {
+      return false;
+    }
+    items.emplace_back(std::move(item));
+    notEmpty.notify_one();
+    return true;
+  }
+
+  /// @return false if the producer is done and the queue has been drained
+  bool pop(StreamedOperation& item) {
+    std::unique_lock lock{mutex};
+    notEmpty.wait(lock, [this] { return !items.empty() || closed; });
+    if (items.empty()) {
+      return false;
+    }
+    item = std::move(items.front());
+    items.pop_front();
+    notFull.notify_one();
+    return true;
+  }
+
+  /// Called by the producer once all operations have been pushed
+  void close() {
+    {
+      const std::lock_guard lock{mutex};
+      closed = true;
+    }
+    notEmpty.notify_all();
+  }
+
+  /// Called by the consumer if it stops processing operations
+  void cancel() {
+    {
+      const std::lock_guard lock{mutex};
+      cancelled = true;
+    }
+    notFull.notify_all();
+  }
+
+private:
+  std::size_t capacity;
+  std::deque<StreamedOperation> items{};
+  std::mutex mutex;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+  bool closed = false;
+  bool cancelled = false;
+};
+
+/// Multiplies streamed operations into the functionality of a circuit
+template <class Config> class StreamingBuilder {
+public:
+  explicit StreamingBuilder(Package<Config>& pkg)
+      : dd(pkg), e(pkg.makeIdent()) {
+    dd.incRef(e);
+  }
+  StreamingBuilder(const StreamingBuilder&) = delete;
+  StreamingBuilder& operator=(const StreamingBuilder&) = delete;
+  ~StreamingBuilder() {
+    if (!finished) {
+      dd.decRef(e);
+    }
+  }
+
+  void apply(StreamedOperation item) {
+    if (item.layout.has_value()) {
+      permutation = std::move(*item.layout);
+    }
+    if (dd.qubits() < item.nqubits) {
+      dd.resize(item.nqubits);
+    }
+    // qubits added after the first operation start in their initial position
+    if (!permutation.empty()) {
+      for (auto q = static_cast<Qubit>(knownQubits); q < item.nqubits; ++q) {
+        permutation.try_emplace(q, q);
+      }
+    }
+    knownQubits = std::max(knownQubits, item.nqubits);
+
+    auto tmp = dd.multiply(getDD(item.op.get(), dd, permutation), e);
+    dd.incRef(tmp);
+    dd.decRef(e);
+    e = tmp;
+    dd.garbageCollect();
+  }
+
+  /// Finish the construction once the whole circuit has been imported
+  MatrixDD finish(const QuantumComputation& qc) {
+    if (dd.qubits() < qc.getNqubits()) {
+      dd.resize(qc.getNqubits());
+    }
+    // without a layout, SWAP gates have been applied as regular gates
+    if (permutation.empty()) {
+      permutation = qc.initialLayout;
+    }
+    auto f = dd.multiply(e, dd.createInitialMatrix(qc.ancillary));
+    dd.incRef(f);
+    dd.decRef(e);
+    finished = true;
+
+    // correct permutation if necessary
+    changePermutation(f, permutation, qc.outputPermutation, dd);
+    f = dd.reduceAncillae(f, qc.ancillary);
+    f = dd.reduceGarbage(f, qc.garbage);
+    return f;
+  }
+
+private:
+  Package<Config>& dd;
+  MatrixDD e;
+  Permutation permutation{};
+  std::size_t knownQubits = 0U;
+  bool finished = false;
+};
+
+/**
+ * @brief Build the functionality of a circuit that is streamed by `import`
+ * @param import Callable importing the circuit into a QuantumComputation while
+ * passing its operations to the given sink
+ */
+template <class Config, class Import>
+MatrixDD buildStreaming(const Import& import, Package<Config>& dd,
+                        const bool concurrent,
+                        const std::size_t queueCapacity) {
+  QuantumComputation qc{};
+  StreamingBuilder<Config> builder{dd};
+  bool first = true;
+  const auto wrap = [&qc, &first](std::unique_ptr<Operation> op) {
+    StreamedOperation item{std::move(op), qc.getNqubits(), std::nullopt};
+    if (first) {
+      item.layout = qc.initialLayout;
+      first = false;
+    }
+    return item;
+  };
+
+  if (!concurrent) {
+    import(qc, [&](std::unique_ptr<Operation> op) {
+      builder.apply(wrap(std::move(op)));
+    });
+    return builder.finish(qc);
+  }
+
+  // the circuit is only accessed by the parsing thread until it is joined
+  OperationQueue queue{queueCapacity};
+  std::exception_ptr parseError{};
+  std::thread parser([&]() {
+    try {
+      import(qc, [&](std::unique_ptr<Operation> op) {
+        if (!queue.push(wrap(std::move(op)))) {
+          throw StreamingCancelled{};
+        }
+      });
+    } catch (const StreamingCancelled&) {
+      // the builder has failed and reports its own error
+    } catch (...) {
+      parseError = std::current_exception();
+    }
+    queue.close();
+  });
+  try {
+    StreamedOperation item{};
+    while (queue.pop(item)) {
+      builder.apply(std::move(item));
+    }
+  } catch (...) {
+    queue.cancel();
+    parser.join();
+    throw;
+  }
+  parser.join();
+  if (parseError) {
+    std::rethrow_exception(parseError);
+  }
+  return builder.finish(qc);
+}
+} // namespace
+
 template <class Config>
 MatrixDD buildFunctionality(const QuantumComputation* qc, Package<Config>& dd) {
+  return buildFunctionality(qc, dd, CheckpointConfig{});
+}
+
+template <class Config>
+MatrixDD buildFunctionality(const QuantumComputation* qc, Package<Config>& dd,
+                            const CheckpointConfig& checkpoint) {
   const auto nq = qc->getNqubits();
   if (nq == 0U) {
     return MatrixDD::one();
   }
 
-  auto permutation = qc->initialLayout;
   auto e = dd.createInitialMatrix(qc->ancillary);
+  return buildFunctionalityFrom(qc, dd, e, qc->initialLayout, 0U, checkpoint);
+}
 
-  for (const auto& op : *qc) {
-    auto tmp = dd.multiply(getDD(op.get(), dd, permutation), e);
+template <class Config>
+MatrixDD resumeFunctionality(const QuantumComputation* qc, Package<Config>& dd,
+                             const std::string& file,
+                             const CheckpointConfig& checkpoint) {
+  auto resumed = readCheckpoint<mNode>(file, dd);
+  if (resumed.circuitSize != qc->size() || resumed.next > qc->size()) {
+    dd.decRef(resumed.state);
+    throw std::invalid_argument("Checkpoint " + file +
+                                " does not belong to this circuit.");
+  }
+  return buildFunctionalityFrom(qc, dd, resumed.state, resumed.permutation,
+                                resumed.next, checkpoint);
+}
 
-    dd.incRef(tmp);
-    dd.decRef(e);
-    e = tmp;
+template <class Config>
+MatrixDD buildFunctionalityFused(const QuantumComputation* qc,
+                                 Package<Config>& dd,
+                                 const std::size_t maxBlockSize) {
+  auto fused = *qc;
+  CircuitOptimizer::collectBlocks(fused, maxBlockSize);
+  return buildFunctionality(&fused, dd);
+}
 
-    dd.garbageCollect();
+template <class Config>
+MatrixDD buildFunctionalityParallel(const QuantumComputation* qc,
+                                   Package<Config>& dd,
+                                   std::size_t numThreads) {
+  const auto nq = qc->getNqubits();
+  if (nq == 0U) {
+    return MatrixDD::one();
+  }
+  if (numThreads == 0U) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  const auto numChunks = std::min(numThreads, qc->size());
+  if (numChunks <= 1U) {
+    return buildFunctionality(qc, dd);
+  }
+
+  // split the circuit into chunks and determine the permutation at the start
+  // of every chunk
+  std::vector<std::size_t> bounds(numChunks + 1U);
+  for (std::size_t c = 0U; c <= numChunks; ++c) {
+    bounds[c] = c * qc->size() / numChunks;
+  }
+  std::vector<Permutation> permutations(numChunks);
+  auto permutation = qc->initialLayout;
+  for (std::size_t c = 0U; c < numChunks; ++c) {
+    permutations[c] = permutation;
+    for (auto i = bounds[c]; i < bounds[c + 1U]; ++i) {
+      updatePermutation(qc->at(i).get(), permutation);
+    }
+  }
+
+  // build the product of every chunk in a private package
+  std::vector<std::unique_ptr<Package<Config>>> workers(numChunks);
+  std::vector<MatrixDD> products(numChunks);
+  runWorkers(numChunks, [&](const std::size_t c) {
+    workers[c] = std::make_unique<Package<Config>>(nq);
+    auto& pkg = *workers[c];
+    auto e = pkg.makeIdent();
+    pkg.incRef(e);
+    for (auto i = bounds[c]; i < bounds[c + 1U]; ++i) {
+      auto tmp = pkg.multiply(getDD(qc->at(i).get(), pkg, permutations[c]), e);
+      pkg.incRef(tmp);
+      pkg.decRef(e);
+      e = tmp;
+      pkg.garbageCollect();
+    }
+    products[c] = e;
+  });
+
+  // combine the products in a tree. In every round, the worker holding the
+  // earlier chunk pulls the product of the later chunk from its neighbour,
+  // whose package is not modified in that round.
+  for (std::size_t stride = 1U; stride < numChunks; stride *= 2U) {
+    const auto numPairs = (numChunks + stride - 1U) / (2U * stride);
+    runWorkers(numPairs, [&](const std::size_t k) {
+      const auto c = 2U * stride * k;
+      auto& pkg = *workers[c];
+      auto later = pkg.transfer(products[c + stride]);
+      pkg.incRef(later);
+      auto tmp = pkg.multiply(later, products[c]);
+      pkg.incRef(tmp);
+      pkg.decRef(later);
+      pkg.decRef(products[c]);
+      products[c] = tmp;
+      workers[c + stride].reset();
+      pkg.garbageCollect();
+    });
   }
+
+  auto e = dd.multiply(dd.transfer(products[0U]),
+                       dd.createInitialMatrix(qc->ancillary));
+  dd.incRef(e);
+  workers[0U].reset();
+
   // correct permutation if necessary
   changePermutation(e, permutation, qc->outputPermutation, dd);
   e = dd.reduceAncillae(e, qc->ancillary);
@@ -35,6 +432,30 @@ MatrixDD buildFunctionality(const QuantumComputation* qc, Package<Config>& dd) {
   return e;
 }
 
+template <class Config>
+MatrixDD buildFunctionalityStreaming(const std::string& filename,
+                                    Package<Config>& dd, const bool concurrent,
+                                    const std::size_t queueCapacity) {
+  return buildStreaming(
+      [&filename](QuantumComputation& qc,
+                  QuantumComputation::OperationSink sink) {
+        qc.importStreaming(filename, std::move(sink));
+      },
+      dd, concurrent, queueCapacity);
+}
+
+template <class Config>
+MatrixDD buildFunctionalityStreaming(std::istream& is, const Format format,
+                                    Package<Config>& dd, const bool concurrent,
+                                    const std::size_t queueCapacity) {
+  return buildStreaming(
+      [&is, format](QuantumComputation& qc,
+                    QuantumComputation::OperationSink sink) {
+        qc.importStreaming(is, format, std::move(sink));
+      },
+      dd, concurrent, queueCapacity);
+}
+
 template <class Config>
 MatrixDD buildFunctionalityRecursive(const QuantumComputation* qc,
                                      Package<Config>& dd) {
@@ -126,6 +547,63 @@ buildFunctionality(const qc::QuantumComputation* qc,
 
 template MatrixDD buildFunctionality(const qc::QuantumComputation* qc,
                                      UnitarySimulatorDDPackage& dd);
+template MatrixDD
+buildFunctionality(const qc::QuantumComputation* qc,
+                   Package<dd::OpenAddressingDDPackageConfig>& dd);
+
+template MatrixDD buildFunctionality(const qc::QuantumComputation* qc,
+                                     Package<DDPackageConfig>& dd,
+                                     const CheckpointConfig& checkpoint);
+template MatrixDD buildFunctionality(const qc::QuantumComputation* qc,
+                                     UnitarySimulatorDDPackage& dd,
+                                     const CheckpointConfig& checkpoint);
+template MatrixDD resumeFunctionality(const qc::QuantumComputation* qc,
+                                      Package<DDPackageConfig>& dd,
+                                      const std::string& file,
+                                      const CheckpointConfig& checkpoint);
+template MatrixDD resumeFunctionality(const qc::QuantumComputation* qc,
+                                      UnitarySimulatorDDPackage& dd,
+                                      const std::string& file,
+                                      const CheckpointConfig& checkpoint);
+
+template MatrixDD buildFunctionalityFused(const qc::QuantumComputation* qc,
+                                          Package<DDPackageConfig>& dd,
+                                          std::size_t maxBlockSize);
+template MatrixDD buildFunctionalityFused(const qc::QuantumComputation* qc,
+                                          UnitarySimulatorDDPackage& dd,
+                                          std::size_t maxBlockSize);
+template MatrixDD
+buildFunctionalityFused(const qc::QuantumComputation* qc,
+                        Package<dd::OpenAddressingDDPackageConfig>& dd,
+                        std::size_t maxBlockSize);
+
+template MatrixDD buildFunctionalityParallel(const qc::QuantumComputation* qc,
+                                             Package<DDPackageConfig>& dd,
+                                             std::size_t numThreads);
+template MatrixDD buildFunctionalityParallel(const qc::QuantumComputation* qc,
+                                             UnitarySimulatorDDPackage& dd,
+                                             std::size_t numThreads);
+template MatrixDD
+buildFunctionalityParallel(const qc::QuantumComputation* qc,
+                           Package<dd::OpenAddressingDDPackageConfig>& dd,
+                           std::size_t numThreads);
+
+template MatrixDD buildFunctionalityStreaming(const std::string& filename,
+                                              Package<DDPackageConfig>& dd,
+                                              bool concurrent,
+                                              std::size_t queueCapacity);
+template MatrixDD buildFunctionalityStreaming(std::istream& is, Format format,
+                                              Package<DDPackageConfig>& dd,
+                                              bool concurrent,
+                                              std::size_t queueCapacity);
+template MatrixDD buildFunctionalityStreaming(const std::string& filename,
+                                              UnitarySimulatorDDPackage& dd,
+                                              bool concurrent,
+                                              std::size_t queueCapacity);
+template MatrixDD buildFunctionalityStreaming(std::istream& is, Format format,
+                                              UnitarySimulatorDDPackage& dd,
+                                              bool concurrent,
+                                              std::size_t queueCapacity);
 
 template MatrixDD buildFunctionalityRecursive(const qc::QuantumComputation* qc,
                                               Package<DDPackageConfig>& dd);
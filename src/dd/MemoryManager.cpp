@@ -3,11 +3,38 @@
 #include "dd/Node.hpp"
 #include "dd/RealNumber.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define MQT_CORE_DD_HAS_MMAP 1
+#endif
 
 namespace dd {
 
+template <typename T>
+MemoryManager<T>::MemoryManager(const std::size_t initialAllocationSize,
+                                const bool useArena)
+    : arena(useArena) {
+#ifndef MQT_CORE_DD_HAS_MMAP
+  arena = false;
+#endif
+  pushChunk(allocateChunk(initialAllocationSize));
+}
+
+template <typename T> MemoryManager<T>::~MemoryManager() {
+  for (const auto& chunk : chunks) {
+    releaseChunk(chunk);
+  }
+}
+
 template <typename T> T* MemoryManager<T>::get() {
   if (entryAvailableForReuse()) {
     return getEntryFromAvailableList();
@@ -28,23 +55,101 @@ template <typename T> void MemoryManager<T>::returnEntry(T* entry) noexcept {
   stats.trackReturnedEntry();
 }
 
-template <typename T>
-void MemoryManager<T>::reset(const bool resizeToTotal) noexcept {
+template <typename T> void MemoryManager<T>::reset(const bool resizeToTotal) {
   available = nullptr;
 
   auto numAllocations = stats.numAllocations;
-  chunks.resize(1U);
+  const auto numReleasedChunks = stats.numReleasedChunks;
+  const auto numAllocated = stats.numAllocated;
+  for (std::size_t i = 1U; i < chunks.size(); ++i) {
+    releaseChunk(chunks[i]);
+  }
+  auto first = chunks[0];
+  chunks.clear();
+  stats.reset();
   if (resizeToTotal) {
-    chunks[0].resize(stats.numAllocated);
+    if (first.size < numAllocated) {
+      releaseChunk(first);
+      first = allocateChunk(numAllocated);
+    }
     ++numAllocations;
   }
+  pushChunk(first);
 
-  chunkIt = chunks[0].begin();
-  chunkEndIt = chunks[0].end();
-
-  stats.reset();
   stats.numAllocations = numAllocations;
-  stats.numAllocated = chunks[0].size();
+  stats.numReleasedChunks = numReleasedChunks;
+}
+
+template <typename T> std::size_t MemoryManager<T>::releaseEmptyChunks() {
+  if (chunks.size() <= 1U || !entryAvailableForReuse()) {
+    return 0U;
+  }
+
+  // all chunks but the current one, sorted by address
+  const auto numCandidates = chunks.size() - 1U;
+  std::vector<std::size_t> order(numCandidates);
+  for (std::size_t i = 0U; i < numCandidates; ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this](const auto a, const auto b) {
+    return std::less<const T*>{}(chunks[a].data, chunks[b].data);
+  });
+  const auto chunkOf = [&](const T* entry) {
+    const auto it = std::upper_bound(
+        order.begin(), order.end(), entry, [this](const T* e, const auto i) {
+          return std::less<const T*>{}(e, chunks[i].data);
+        });
+    if (it == order.begin()) {
+      return numCandidates;
+    }
+    const auto& chunk = chunks[*std::prev(it)];
+    if (std::less<const T*>{}(entry, chunk.data + chunk.size)) {
+      return *std::prev(it);
+    }
+    return numCandidates;
+  };
+
+  // count the available entries per chunk
+  std::vector<std::size_t> numFree(numCandidates, 0U);
+  for (const auto* entry = available; entry != nullptr; entry = entry->next) {
+    if (const auto i = chunkOf(entry); i < numCandidates) {
+      ++numFree[i];
+    }
+  }
+  std::vector<bool> release(numCandidates, false);
+  std::size_t numReleased = 0U;
+  for (std::size_t i = 0U; i < numCandidates; ++i) {
+    if (numFree[i] == chunks[i].size) {
+      release[i] = true;
+      ++numReleased;
+    }
+  }
+  if (numReleased == 0U) {
+    return 0U;
+  }
+
+  // unlink the entries of released chunks from the available list
+  T** link = &available;
+  while (*link != nullptr) {
+    if (const auto i = chunkOf(*link); i < numCandidates && release[i]) {
+      *link = (*link)->next;
+    } else {
+      link = &(*link)->next;
+    }
+  }
+
+  std::vector<Chunk> remaining{};
+  remaining.reserve(chunks.size() - numReleased);
+  for (std::size_t i = 0U; i < chunks.size(); ++i) {
+    if (i < numCandidates && release[i]) {
+      stats.trackReleasedChunk(chunks[i].size, chunks[i].bytes);
+      releaseChunk(chunks[i]);
+    } else {
+      remaining.emplace_back(chunks[i]);
+    }
+  }
+  chunks = std::move(remaining);
+  return numReleased;
 }
 
 template <typename T>
@@ -59,18 +164,64 @@ T* MemoryManager<T>::getEntryFromAvailableList() noexcept {
 template <typename T> void MemoryManager<T>::allocateNewChunk() {
   assert(!entryAvailableInChunk());
   const auto newChunkSize = static_cast<std::size_t>(
-      GROWTH_FACTOR * static_cast<double>(chunks.back().size()));
-  chunks.emplace_back(newChunkSize);
-  chunkIt = chunks.back().begin();
-  chunkEndIt = chunks.back().end();
+      GROWTH_FACTOR * static_cast<double>(chunks.back().size));
+  pushChunk(allocateChunk(newChunkSize));
+}
+
+template <typename T>
+typename MemoryManager<T>::Chunk
+MemoryManager<T>::allocateChunk(const std::size_t numEntries) const {
+  Chunk chunk{};
+#ifdef MQT_CORE_DD_HAS_MMAP
+  if (arena) {
+    const auto bytes = std::max<std::size_t>(numEntries * sizeof(T), 1U);
+    chunk.bytes = (bytes + HUGE_PAGE_SIZE - 1U) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    auto* mem = mmap(nullptr, chunk.bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    // only a hint, failure (e.g., THP disabled) is not an error
+    madvise(mem, chunk.bytes, MADV_HUGEPAGE);
+#endif
+    chunk.data = static_cast<T*>(mem);
+    chunk.size = chunk.bytes / sizeof(T);
+    chunk.mapped = true;
+    return chunk;
+  }
+#endif
+  chunk.bytes = numEntries * sizeof(T);
+  chunk.data = static_cast<T*>(::operator new(chunk.bytes));
+  chunk.size = numEntries;
+  return chunk;
+}
+
+template <typename T>
+void MemoryManager<T>::releaseChunk(const Chunk& chunk) noexcept {
+#ifdef MQT_CORE_DD_HAS_MMAP
+  if (chunk.mapped) {
+    munmap(chunk.data, chunk.bytes);
+    return;
+  }
+#endif
+  ::operator delete(chunk.data);
+}
+
+template <typename T> void MemoryManager<T>::pushChunk(const Chunk& chunk) {
+  chunks.emplace_back(chunk);
+  chunkIt = chunk.data;
+  chunkEndIt = chunk.data + chunk.size;
   ++stats.numAllocations;
-  stats.numAllocated += newChunkSize;
+  stats.numAllocated += chunk.size;
+  stats.trackReservedBytes(chunk.bytes);
 }
 
 template <typename T> T* MemoryManager<T>::getEntryFromChunk() noexcept {
   assert(!entryAvailableForReuse());
   assert(entryAvailableInChunk());
-  auto* entry = &(*chunkIt);
+  // entries are constructed lazily so that untouched pages stay unbacked
+  auto* entry = new (chunkIt) T{};
   ++chunkIt;
   stats.trackUsedEntries();
   return entry;
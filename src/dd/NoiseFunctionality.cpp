@@ -6,19 +6,27 @@
 #include "dd/DDpackageConfig.hpp"
 #include "dd/GateMatrixDefinitions.hpp"
 #include "dd/Node.hpp"
+#include "dd/Operations.hpp"
 #include "dd/Package.hpp"
+#include "dd/Sampler.hpp"
+#include "ir/QuantumComputation.hpp"
 #include "ir/operations/OpType.hpp"
 #include "ir/operations/Operation.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <memory>
 #include <random>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -246,14 +254,17 @@ DeterministicNoiseFunctionality::DeterministicNoiseFunctionality(
                                   ampDampProbSingleQubit, 1);
   sanityCheckOfNoiseProbabilities(noiseProbabilityMultiQubit,
                                   ampDampProbMultiQubit, 1);
+  // cached results depend on the noise probabilities
+  package->densityNoise.clear();
 }
 
 void DeterministicNoiseFunctionality::applyNoiseEffects(
     dEdge& originalEdge, const std::unique_ptr<qc::Operation>& qcOperation) {
   auto usedQubits = qcOperation->getUsedQubits();
+  const NoiseQubits key(usedQubits);
   dCachedEdge nodeAfterNoise = {};
   dEdge::applyDmChangesToEdge(originalEdge);
-  nodeAfterNoise = applyNoiseEffects(originalEdge, usedQubits, false,
+  nodeAfterNoise = applyNoiseEffects(originalEdge, usedQubits, key, false,
                                      static_cast<Qubit>(nQubits));
   dEdge::revertDmChangesToEdge(originalEdge);
   auto r = dEdge{nodeAfterNoise.p, package->cn.lookup(nodeAfterNoise.w)};
@@ -266,7 +277,7 @@ void DeterministicNoiseFunctionality::applyNoiseEffects(
 
 dCachedEdge DeterministicNoiseFunctionality::applyNoiseEffects(
     dEdge& originalEdge, const std::set<qc::Qubit>& usedQubits,
-    const bool firstPathEdge, const Qubit level) {
+    const NoiseQubits& key, const bool firstPathEdge, const Qubit level) {
 
   const auto originalWeight = static_cast<ComplexValue>(originalEdge.w);
   if (originalEdge.isZeroTerminal() || level <= *usedQubits.begin()) {
@@ -274,13 +285,25 @@ dCachedEdge DeterministicNoiseFunctionality::applyNoiseEffects(
   }
 
   auto originalCopy = dEdge{originalEdge.p, Complex::one()};
+  // off the first path, the result only depends on the node (including its
+  // temporary density matrix flags) as long as no level has been skipped
+  const bool cacheable = !firstPathEdge && !originalCopy.isTerminal() &&
+                         originalCopy.p->v + 1U == level;
+  if (cacheable) {
+    const auto cached = package->densityNoise.lookup(originalCopy, key);
+    if (cached.p != nullptr) {
+      return {cached.p, static_cast<ComplexValue>(cached.w) * originalWeight};
+    }
+  }
   ArrayOfEdges newEdges{};
   const auto nextLevel = static_cast<dd::Qubit>(level - 1U);
   if (originalEdge.isIdentity()) {
     newEdges[0] =
-        applyNoiseEffects(originalCopy, usedQubits, firstPathEdge, nextLevel);
+        applyNoiseEffects(originalCopy, usedQubits, key, firstPathEdge,
+                          nextLevel);
     newEdges[3] =
-        applyNoiseEffects(originalCopy, usedQubits, firstPathEdge, nextLevel);
+        applyNoiseEffects(originalCopy, usedQubits, key, firstPathEdge,
+                          nextLevel);
   } else {
     for (std::size_t i = 0; i < newEdges.size(); i++) {
       auto& successor = originalCopy.p->e[i];
@@ -288,7 +311,8 @@ dCachedEdge DeterministicNoiseFunctionality::applyNoiseEffects(
         // If I am to the firstPathEdge I cannot minimize the necessary
         // operations anymore
         dEdge::applyDmChangesToEdge(successor);
-        newEdges[i] = applyNoiseEffects(successor, usedQubits, true, nextLevel);
+        newEdges[i] =
+            applyNoiseEffects(successor, usedQubits, key, true, nextLevel);
         dEdge::revertDmChangesToEdge(successor);
       } else if (i == 2) {
         // Since e[1] == e[2] (due to density matrix representation), I can skip
@@ -297,7 +321,7 @@ dCachedEdge DeterministicNoiseFunctionality::applyNoiseEffects(
       } else {
         dEdge::applyDmChangesToEdge(successor);
         newEdges[i] =
-            applyNoiseEffects(successor, usedQubits, false, nextLevel);
+            applyNoiseEffects(successor, usedQubits, key, false, nextLevel);
         dEdge::revertDmChangesToEdge(successor);
       }
     }
@@ -329,6 +353,10 @@ dCachedEdge DeterministicNoiseFunctionality::applyNoiseEffects(
   }
 
   auto e = package->makeDDNode(nextLevel, newEdges, firstPathEdge);
+  if (cacheable) {
+    package->densityNoise.insert(
+        originalCopy, dEdge{e.p, package->cn.lookup(e.w)}, key);
+  }
   if (e.w.exactlyZero()) {
     return e;
   }
@@ -462,4 +490,96 @@ void sanityCheckOfNoiseProbabilities(const double noiseProbability,
         std::to_string(amplitudeDampingProb * multiQubitGateFactor));
   }
 }
+
+Histogram simulateStochasticTrajectories(
+    const qc::QuantumComputation& qc, const std::size_t trajectories,
+    const std::size_t shotsPerTrajectory, const double gateNoiseProbability,
+    const double amplitudeDampingProb, const double multiQubitGateFactor,
+    const std::string& noiseEffects, std::size_t seed,
+    std::size_t numThreads) {
+  sanityCheckOfNoiseProbabilities(gateNoiseProbability, amplitudeDampingProb,
+                                  multiQubitGateFactor);
+  if (seed == 0U) {
+    std::random_device rd;
+    seed = (static_cast<std::size_t>(rd()) << 32U) ^ rd();
+  }
+  if (numThreads == 0U) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  numThreads = std::max<std::size_t>(1U, std::min(numThreads, trajectories));
+
+  const auto nqubits = qc.getNqubits();
+  std::atomic<std::size_t> next{0U};
+  std::vector<Histogram> histograms(numThreads);
+  std::vector<std::exception_ptr> errors(numThreads);
+  const auto work = [&](const std::size_t t) {
+    try {
+      auto dd =
+          std::make_unique<Package<StochasticNoiseSimulatorDDPackageConfig>>(
+              nqubits);
+      StochasticNoiseFunctionality noise(dd, nqubits, gateNoiseProbability,
+                                         amplitudeDampingProb,
+                                         multiQubitGateFactor, noiseEffects);
+      auto& histogram = histograms[t];
+      for (auto i = next++; i < trajectories; i = next++) {
+        std::seed_seq seeds{static_cast<std::uint32_t>(seed),
+                            static_cast<std::uint32_t>(seed >> 32U),
+                            static_cast<std::uint32_t>(i),
+                            static_cast<std::uint32_t>(i >> 32U)};
+        std::mt19937_64 generator(seeds);
+
+        auto permutation = qc.initialLayout;
+        auto state = dd->makeZeroState(nqubits);
+        dd->incRef(state);
+        for (const auto& op : qc) {
+          if (!op->isUnitary()) {
+            continue;
+          }
+          std::set<qc::Qubit> targets{};
+          for (const auto q : op->getUsedQubits()) {
+            targets.emplace(permutation.at(q));
+          }
+          noise.applyNoiseOperation(targets, getDD(op.get(), *dd, permutation),
+                                    state, generator);
+          dd->garbageCollect();
+        }
+        changePermutation(state, permutation, qc.outputPermutation, *dd);
+
+        const Sampler sampler(state);
+        const auto shotSeed = generator();
+        for (std::size_t shot = 0U; shot < shotsPerTrajectory; ++shot) {
+          ++histogram[sampler.sampleShot(shotSeed, shot)];
+        }
+        dd->decRef(state);
+        dd->garbageCollect();
+      }
+    } catch (...) {
+      errors[t] = std::current_exception();
+      // let the other workers drain the remaining trajectories
+      next = trajectories;
+    }
+  };
+  std::vector<std::thread> threads{};
+  threads.reserve(numThreads - 1U);
+  for (std::size_t t = 1U; t < numThreads; ++t) {
+    threads.emplace_back(work, t);
+  }
+  work(0U);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  auto result = std::move(histograms[0]);
+  for (std::size_t t = 1U; t < numThreads; ++t) {
+    for (const auto& [outcome, count] : histograms[t]) {
+      result[outcome] += count;
+    }
+  }
+  return result;
+}
 } // namespace dd
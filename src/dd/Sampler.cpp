@@ -0,0 +1,160 @@
+#include "dd/Sampler.hpp"
+
+#include "dd/ComplexNumbers.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/Node.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dd {
+namespace {
+constexpr std::uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15ULL;
+
+constexpr std::uint64_t mix(std::uint64_t z) noexcept {
+  z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31U);
+}
+
+/// A uniformly distributed number in [0, 1) from a SplitMix64 stream
+inline fp uniform(std::uint64_t& state) noexcept {
+  state += GOLDEN_GAMMA;
+  return static_cast<fp>(mix(state) >> 11U) * 0x1.0p-53;
+}
+
+struct Annotation {
+  std::uint32_t index;
+  /// The squared norm of the sub-vector below the node
+  fp norm;
+};
+} // namespace
+
+Sampler::Sampler(const vEdge& state) {
+  if (state.w.exactlyZero()) {
+    throw std::runtime_error(
+        "Numerical instabilities led to a 0-vector! Abort simulation!");
+  }
+  if (state.isTerminal()) {
+    return;
+  }
+  nqubits = static_cast<std::size_t>(state.p->v) + 1U;
+  if (nqubits > MAX_QUBITS) {
+    throw std::invalid_argument("Sampling is limited to " +
+                                std::to_string(MAX_QUBITS) + " qubits.");
+  }
+
+  // successors are annotated before their parents (post-order), so the
+  // recursion depth is bounded by the number of qubits
+  std::unordered_map<const vNode*, Annotation> annotations{};
+  const auto annotate = [&](const auto& self, const vNode* p) -> Annotation {
+    if (const auto it = annotations.find(p); it != annotations.end()) {
+      return it->second;
+    }
+    Entry entry{};
+    entry.bit = std::uint64_t{1} << p->v;
+    std::array<fp, RADIX> mass{};
+    for (std::size_t i = 0U; i < RADIX; ++i) {
+      const auto& e = p->e[i];
+      entry.successors[i] = TERMINAL;
+      if (e.w.exactlyZero()) {
+        continue;
+      }
+      fp norm = 1.;
+      if (!e.isTerminal()) {
+        const auto successor = self(self, e.p);
+        entry.successors[i] = successor.index;
+        norm = successor.norm;
+      }
+      mass[i] = ComplexNumbers::mag2(e.w) * norm;
+    }
+    const auto total = mass[0] + mass[1];
+    entry.p0 = total > 0. ? mass[0] / total : 0.5;
+    if (entries.size() >= TERMINAL) {
+      throw std::runtime_error("Too many nodes to sample from.");
+    }
+    const Annotation annotation{static_cast<std::uint32_t>(entries.size()),
+                                total};
+    entries.emplace_back(entry);
+    annotations.emplace(p, annotation);
+    return annotation;
+  };
+  const auto annotation = annotate(annotate, state.p);
+  if (annotation.norm <= 0.) {
+    throw std::runtime_error(
+        "Numerical instabilities led to a 0-vector! Abort simulation!");
+  }
+  root = annotation.index;
+}
+
+std::uint64_t Sampler::sampleShot(const std::uint64_t seed,
+                                  const std::uint64_t shot) const noexcept {
+  auto state = mix(seed ^ mix(shot + GOLDEN_GAMMA));
+  std::uint64_t outcome = 0U;
+  auto index = root;
+  while (index != TERMINAL) {
+    const auto& entry = entries[index];
+    if (uniform(state) < entry.p0) {
+      index = entry.successors[0];
+    } else {
+      outcome |= entry.bit;
+      index = entry.successors[1];
+    }
+  }
+  return outcome;
+}
+
+Histogram Sampler::sample(const std::size_t shots, const std::uint64_t seed,
+                          std::size_t numThreads) const {
+  if (numThreads == 0U) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  numThreads = std::max<std::size_t>(1U, std::min(numThreads, shots));
+
+  std::vector<Histogram> histograms(numThreads);
+  const auto work = [&](const std::size_t t) {
+    const auto begin = shots * t / numThreads;
+    const auto end = shots * (t + 1U) / numThreads;
+    auto& histogram = histograms[t];
+    for (auto shot = begin; shot < end; ++shot) {
+      ++histogram[sampleShot(seed, shot)];
+    }
+  };
+  std::vector<std::thread> threads{};
+  threads.reserve(numThreads - 1U);
+  for (std::size_t t = 1U; t < numThreads; ++t) {
+    threads.emplace_back(work, t);
+  }
+  work(0U);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto result = std::move(histograms[0]);
+  for (std::size_t t = 1U; t < numThreads; ++t) {
+    for (const auto& [outcome, count] : histograms[t]) {
+      result[outcome] += count;
+    }
+  }
+  return result;
+}
+
+std::string Sampler::toBitString(const std::uint64_t outcome) const {
+  std::string result(nqubits, '0');
+  for (std::size_t q = 0U; q < nqubits; ++q) {
+    if (((outcome >> q) & 1U) != 0U) {
+      result[nqubits - 1U - q] = '1';
+    }
+  }
+  return result;
+}
+
+} // namespace dd
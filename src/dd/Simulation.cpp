@@ -1,30 +1,207 @@
 #include "dd/Simulation.hpp"
 
 #include "Definitions.hpp"
+#include "dd/Checkpoint.hpp"
+#include "dd/ComplexNumbers.hpp"
+#include "dd/ComplexValue.hpp"
 #include "dd/DDDefinitions.hpp"
+#include "dd/DenseExport.hpp"
 #include "dd/GateMatrixDefinitions.hpp"
 #include "dd/Package.hpp"
 #include "dd/RealNumber.hpp"
+#include "dd/Sampler.hpp"
 #include "ir/QuantumComputation.hpp"
 #include "ir/operations/ClassicControlledOperation.hpp"
 #include "ir/operations/NonUnitaryOperation.hpp"
 #include "ir/operations/OpType.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <complex>
 #include <cstddef>
+#include <limits>
 #include <map>
 #include <random>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace dd {
+namespace {
+/// A state reached by a number of shots with the same measurement history
+struct Branch {
+  vEdge state;
+  Permutation permutation;
+  std::map<std::size_t, char> measurements;
+  /// The index of the next operation to apply
+  std::size_t next = 0U;
+  std::size_t shots = 0U;
+};
+
+/**
+ * @brief Measure a qubit in all given branches
+ * @details The shots of each branch are split among both outcomes according
+ * to a binomial distribution, which is the distribution of the outcomes of
+ * independent single-shot measurements. Each outcome that occurs continues as
+ * its own branch with the collapsed state.
+ * @return The branches after the measurement, paired with the outcome
+ */
+template <class Config>
+std::vector<std::pair<Branch, char>>
+measureBranches(std::vector<Branch> branches, const qc::Qubit qubit,
+                Package<Config>& dd, std::mt19937_64& mt) {
+  std::vector<std::pair<Branch, char>> result{};
+  for (auto& branch : branches) {
+    const auto level = static_cast<Qubit>(branch.permutation.at(qubit));
+    const auto [pzero, pone] =
+        dd.determineMeasurementProbabilities(branch.state, level, true);
+    const auto sum = pzero + pone;
+    // @see Package::measureOneCollapsing
+    if (std::abs(sum - 1) > 0.001) {
+      throw std::runtime_error(
+          "Numerical instability occurred during measurement: |alpha|^2 + "
+          "|beta|^2 = " +
+          std::to_string(pzero) + " + " + std::to_string(pone) + " = " +
+          std::to_string(sum) + ", but should be 1!");
+    }
+    std::binomial_distribution<std::size_t> dist(branch.shots, pzero / sum);
+    const auto zeros = dist(mt);
+    const auto ones = branch.shots - zeros;
+    if (zeros > 0U && ones > 0U) {
+      auto one = branch;
+      dd.incRef(one.state);
+      dd.performCollapsingMeasurement(one.state, level, pone, false);
+      one.shots = ones;
+      result.emplace_back(std::move(one), '1');
+    }
+    if (zeros > 0U) {
+      dd.performCollapsingMeasurement(branch.state, level, pzero, true);
+      branch.shots = zeros;
+      result.emplace_back(std::move(branch), '0');
+    } else {
+      dd.performCollapsingMeasurement(branch.state, level, pone, false);
+      result.emplace_back(std::move(branch), '1');
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Simulate a dynamic circuit for multiple shots
+ * @details Instead of simulating every shot on its own, the shots are
+ * processed as a tree of branches. All shots start in the same branch, so
+ * that the operations up to the first measurement are applied only once.
+ * Whenever a qubit is measured (or reset), the shots of a branch are split
+ * among the outcomes and every outcome that occurs continues as its own
+ * branch. Hence, shots with equal measurement histories share all work. The
+ * branches are processed depth-first so that only few states are alive at
+ * the same time.
+ */
 template <class Config>
 std::map<std::string, std::size_t>
-simulate(const QuantumComputation* qc, const VectorDD& in, Package<Config>& dd,
-         std::size_t shots, std::size_t seed) {
-  bool isDynamicCircuit = false;
-  bool hasMeasurements = false;
-  bool measurementsLast = true;
+simulateDynamic(const QuantumComputation* qc, const VectorDD& in,
+                Package<Config>& dd, const std::size_t shots,
+                std::mt19937_64& mt) {
+  std::map<std::string, std::size_t> counts{};
+  if (shots == 0U) {
+    return counts;
+  }
+
+  std::vector<Branch> stack{};
+  stack.emplace_back(Branch{in, qc->initialLayout, {}, 0U, shots});
+  dd.incRef(in);
+
+  while (!stack.empty()) {
+    auto branch = std::move(stack.back());
+    stack.pop_back();
+
+    while (branch.next < qc->size()) {
+      const auto* op = qc->at(branch.next++).get();
+      if (const auto* nonunitary = dynamic_cast<const NonUnitaryOperation*>(op);
+          nonunitary != nullptr &&
+          (nonunitary->getType() == Measure ||
+           nonunitary->getType() == Reset)) {
+        const auto& qubits = nonunitary->getTargets();
+        const auto isMeasure = nonunitary->getType() == Measure;
+        std::vector<Branch> branches{};
+        branches.emplace_back(std::move(branch));
+        for (std::size_t j = 0U; j < qubits.size(); ++j) {
+          auto measured =
+              measureBranches(std::move(branches), qubits[j], dd, mt);
+          branches.clear();
+          for (auto& [b, bit] : measured) {
+            if (isMeasure) {
+              b.measurements[nonunitary->getClassics().at(j)] = bit;
+            } else if (bit == '1') {
+              // apply an X operation whenever the measured result is one
+              const auto x =
+                  qc::StandardOperation(b.permutation.at(qubits[j]), qc::X);
+              auto tmp = dd.multiply(getDD(&x, dd), b.state);
+              dd.incRef(tmp);
+              dd.decRef(b.state);
+              b.state = tmp;
+            }
+            branches.emplace_back(std::move(b));
+          }
+        }
+        dd.garbageCollect();
+
+        // continue with one of the branches and defer the others
+        branch = std::move(branches.back());
+        branches.pop_back();
+        for (auto& b : branches) {
+          stack.emplace_back(std::move(b));
+        }
+        continue;
+      }
+
+      if (const auto* classicControlled =
+              dynamic_cast<const ClassicControlledOperation*>(op);
+          classicControlled != nullptr) {
+        const auto& controlRegister = classicControlled->getControlRegister();
+        const auto& expectedValue = classicControlled->getExpectedValue();
+        auto actualValue = 0ULL;
+        // determine the actual value from measurements
+        for (std::size_t j = 0; j < controlRegister.second; ++j) {
+          if (branch.measurements[controlRegister.first + j] == '1') {
+            actualValue |= 1ULL << j;
+          }
+        }
+
+        // do not apply an operation if the value is not the expected one
+        if (actualValue != expectedValue) {
+          continue;
+        }
+      }
 
+      auto tmp = dd.multiply(getDD(op, dd, branch.permutation), branch.state);
+      dd.incRef(tmp);
+      dd.decRef(branch.state);
+      branch.state = tmp;
+
+      dd.garbageCollect();
+    }
+
+    // reduce reference count of measured state
+    dd.decRef(branch.state);
+
+    std::string shot(qc->getNcbits(), '0');
+    for (const auto& [bit, value] : branch.measurements) {
+      shot[qc->getNcbits() - bit - 1U] = value;
+    }
+    counts[shot] += branch.shots;
+  }
+
+  return counts;
+}
+
+/// A generator seeded with `seed` or, if it is zero, from a random device
+std::mt19937_64 makeGenerator(const std::size_t seed) {
   std::mt19937_64 mt{};
   if (seed != 0U) {
     mt.seed(seed);
@@ -38,14 +215,26 @@ simulate(const QuantumComputation* qc, const VectorDD& in, Package<Config>& dd,
     std::seed_seq seeds(std::begin(randomData), std::end(randomData));
     mt.seed(seeds);
   }
+  return mt;
+}
 
+/// Where the measurements of a circuit are and whether it is dynamic
+struct MeasurementInfo {
+  bool isDynamicCircuit = false;
+  bool hasMeasurements = false;
+  /// qubit -> classical bit
   std::map<qc::Qubit, std::size_t> measurementMap{};
+};
+
+MeasurementInfo analyzeMeasurements(const QuantumComputation* qc) {
+  MeasurementInfo info{};
+  bool measurementsLast = true;
 
   // rudimentary check whether circuit is dynamic
   for (const auto& op : *qc) {
     // if it contains any dynamic circuit primitives, it certainly is dynamic
     if (op->isClassicControlledOperation() || op->getType() == qc::Reset) {
-      isDynamicCircuit = true;
+      info.isDynamicCircuit = true;
       break;
     }
 
@@ -53,29 +242,92 @@ simulate(const QuantumComputation* qc, const VectorDD& in, Package<Config>& dd,
     // (qubit -> bit)
     if (const auto* measure = dynamic_cast<qc::NonUnitaryOperation*>(op.get());
         measure != nullptr && measure->getType() == qc::Measure) {
-      hasMeasurements = true;
+      info.hasMeasurements = true;
 
       const auto& quantum = measure->getTargets();
       const auto& classic = measure->getClassics();
 
       for (std::size_t i = 0; i < quantum.size(); ++i) {
-        measurementMap[quantum.at(i)] = classic.at(i);
+        info.measurementMap[quantum.at(i)] = classic.at(i);
       }
     }
 
     // if an operation happens after a measurement, the resulting circuit can
     // only be simulated in single shots
-    if (hasMeasurements &&
+    if (info.hasMeasurements &&
         (op->isUnitary() || op->isClassicControlledOperation())) {
       measurementsLast = false;
     }
   }
 
   if (!measurementsLast) {
-    isDynamicCircuit = true;
+    info.isDynamicCircuit = true;
+  }
+  return info;
+}
+
+/**
+ * @brief Measure all qubits of the final state of a non-dynamic circuit
+ * @param e The final state (with the output permutation applied)
+ * @return The counts of the classical bit strings
+ */
+template <class Config>
+std::map<std::string, std::size_t>
+measureFinalState(const QuantumComputation* qc, const MeasurementInfo& info,
+                  vEdge& e, Package<Config>& dd, const std::size_t shots,
+                  std::mt19937_64& mt) {
+  // measure all qubits
+  std::map<std::string, std::size_t> counts{};
+  if (e.isTerminal() ||
+      static_cast<std::size_t>(e.p->v) < Sampler::MAX_QUBITS) {
+    // annotate the state once and draw all shots from the annotation
+    const Sampler sampler(e);
+    for (const auto& [outcome, count] : sampler.sample(shots, mt())) {
+      counts[sampler.toBitString(outcome)] += count;
+    }
+  } else {
+    for (std::size_t i = 0U; i < shots; ++i) {
+      // measure all returns a string of the form "q(n-1) ... q(0)"
+      auto measurement = dd.measureAll(e, false, mt);
+      counts.operator[](measurement) += 1U;
+    }
   }
 
-  if (!isDynamicCircuit) {
+  std::map<std::string, std::size_t> actualCounts{};
+  for (const auto& [bitstring, count] : counts) {
+    std::string measurement(qc->getNcbits(), '0');
+    if (info.hasMeasurements) {
+      // if the circuit contains measurements, we only want to return the
+      // measured bits
+      for (const auto& [qubit, bit] : info.measurementMap) {
+        // measurement map specifies that the circuit `qubit` is measured into
+        // a certain `bit`
+        measurement[qc->getNcbits() - 1U - bit] =
+            bitstring[bitstring.size() - 1U -
+                      qc->outputPermutation.at(qubit)];
+      }
+    } else {
+      // otherwise, we consider the output permutation for determining where
+      // to measure the qubits to
+      for (const auto& [qubit, bit] : qc->outputPermutation) {
+        measurement[qc->getNcbits() - 1U - bit] =
+            bitstring[bitstring.size() - 1U - qubit];
+      }
+    }
+    actualCounts[measurement] += count;
+  }
+  return actualCounts;
+}
+} // namespace
+
+template <class Config>
+std::map<std::string, std::size_t>
+simulate(const QuantumComputation* qc, const VectorDD& in, Package<Config>& dd,
+         std::size_t shots, std::size_t seed) {
+  auto mt = makeGenerator(seed);
+  const auto info = analyzeMeasurements(qc);
+
+  if (!info.isDynamicCircuit) {
     // if all gates are unitary (besides measurements at the end), we just
     // simulate once and measure all qubits repeatedly
     auto permutation = qc->initialLayout;
@@ -100,122 +352,426 @@ simulate(const QuantumComputation* qc, const VectorDD& in, Package<Config>& dd,
     changePermutation(e, permutation, qc->outputPermutation, dd);
     e = dd.reduceGarbage(e, qc->garbage);
 
-    // measure all qubits
-    std::map<std::string, std::size_t> counts{};
-    for (std::size_t i = 0U; i < shots; ++i) {
-      // measure all returns a string of the form "q(n-1) ... q(0)"
-      auto measurement = dd.measureAll(e, false, mt);
-      counts.operator[](measurement) += 1U;
-    }
+    auto counts = measureFinalState(qc, info, e, dd, shots, mt);
     // reduce reference count of measured state
     dd.decRef(e);
+    return counts;
+  }
 
-    std::map<std::string, std::size_t> actualCounts{};
-    for (const auto& [bitstring, count] : counts) {
-      std::string measurement(qc->getNcbits(), '0');
-      if (hasMeasurements) {
-        // if the circuit contains measurements, we only want to return the
-        // measured bits
-        for (const auto& [qubit, bit] : measurementMap) {
-          // measurement map specifies that the circuit `qubit` is measured into
-          // a certain `bit`
-          measurement[qc->getNcbits() - 1U - bit] =
-              bitstring[bitstring.size() - 1U -
-                        qc->outputPermutation.at(qubit)];
-        }
+  return simulateDynamic(qc, in, dd, shots, mt);
+}
+
+namespace {
+/**
+ * @brief Apply the operations from index `first` onwards to `e`
+ * @param e The state after the first `first` operations (referenced)
+ * @param permutation The permutation after the first `first` operations
+ */
+template <class Config>
+VectorDD simulateFrom(const QuantumComputation* qc, Package<Config>& dd,
+                      VectorDD e, Permutation permutation,
+                      const std::size_t first,
+                      const CheckpointConfig& checkpoint) {
+  Checkpointer<Config, vNode> checkpointer(dd, checkpoint, qc->size());
+  for (auto i = first; i < qc->size(); ++i) {
+    // simply skip any non-unitary
+    if (const auto& op = qc->at(i); op->isUnitary()) {
+      auto tmp = dd.multiply(getDD(op.get(), dd, permutation), e);
+      dd.incRef(tmp);
+      dd.decRef(e);
+      e = tmp;
+
+      dd.garbageCollect();
+    }
+    checkpointer.step(e, i + 1U, permutation);
+  }
+  checkpointer.finish();
+
+  // correct permutation if necessary
+  changePermutation(e, permutation, qc->outputPermutation, dd);
+  e = dd.reduceGarbage(e, qc->garbage);
+
+  return e;
+}
+} // namespace
+
+template <class Config>
+VectorDD simulate(const QuantumComputation* qc, const VectorDD& in,
+                  Package<Config>& dd, const CheckpointConfig& checkpoint) {
+  dd.incRef(in);
+  return simulateFrom(qc, dd, in, qc->initialLayout, 0U, checkpoint);
+}
+
+template <class Config>
+VectorDD resumeSimulation(const QuantumComputation* qc, Package<Config>& dd,
+                          const std::string& file,
+                          const CheckpointConfig& checkpoint) {
+  auto resumed = readCheckpoint<vNode>(file, dd);
+  if (resumed.circuitSize != qc->size() || resumed.next > qc->size()) {
+    dd.decRef(resumed.state);
+    throw std::invalid_argument("Checkpoint " + file +
+                                " does not belong to this circuit.");
+  }
+  return simulateFrom(qc, dd, resumed.state, resumed.permutation,
+                      resumed.next, checkpoint);
+}
+
+template <class Config>
+std::vector<VectorDD> simulateBatch(const QuantumComputation* qc,
+                                    const std::vector<VectorDD>& inputs,
+                                    Package<Config>& dd) {
+  auto permutation = qc->initialLayout;
+  std::vector<VectorDD> states = inputs;
+  for (const auto& e : states) {
+    dd.incRef(e);
+  }
+
+  for (const auto& op : *qc) {
+    // simply skip any non-unitary
+    if (!op->isUnitary()) {
+      continue;
+    }
+
+    // the gate is built once and kept alive while it is applied to all states
+    auto gate = getDD(op.get(), dd, permutation);
+    dd.incRef(gate);
+    for (auto& e : states) {
+      auto tmp = dd.multiply(gate, e);
+      dd.incRef(tmp);
+      dd.decRef(e);
+      e = tmp;
+    }
+    dd.decRef(gate);
+
+    // collecting garbage clears the compute tables, so it is only done once
+    // all states have passed the gate
+    dd.garbageCollect();
+  }
+
+  for (auto& e : states) {
+    // correct permutation if necessary
+    auto perm = permutation;
+    changePermutation(e, perm, qc->outputPermutation, dd);
+    e = dd.reduceGarbage(e, qc->garbage);
+  }
+  return states;
+}
+
+template <class Config>
+std::vector<std::map<std::string, std::size_t>>
+simulateBatch(const QuantumComputation* qc,
+              const std::vector<VectorDD>& inputs, Package<Config>& dd,
+              const std::size_t shots, const std::size_t seed) {
+  const auto info = analyzeMeasurements(qc);
+  if (info.isDynamicCircuit) {
+    throw std::invalid_argument(
+        "Batched simulation does not support dynamic circuits.");
+  }
+
+  auto states = simulateBatch(qc, inputs, dd);
+  std::vector<std::map<std::string, std::size_t>> results{};
+  results.reserve(states.size());
+  for (auto& e : states) {
+    // every input is sampled as if it was simulated on its own
+    auto mt = makeGenerator(seed);
+    results.emplace_back(measureFinalState(qc, info, e, dd, shots, mt));
+    dd.decRef(e);
+  }
+  return results;
+}
+
+namespace {
+/// The squared norm of the vector represented by an edge (memoized per node)
+fp squaredNorm(const vEdge& e, std::unordered_map<const vNode*, fp>& norms) {
+  if (e.w.exactlyZero()) {
+    return 0.;
+  }
+  if (e.isTerminal()) {
+    return ComplexNumbers::mag2(e.w);
+  }
+  auto it = norms.find(e.p);
+  if (it == norms.end()) {
+    const auto norm =
+        squaredNorm(e.p->e[0], norms) + squaredNorm(e.p->e[1], norms);
+    it = norms.emplace(e.p, norm).first;
+  }
+  return ComplexNumbers::mag2(e.w) * it->second;
+}
+
+using EdgeSet = std::set<std::pair<const vNode*, std::size_t>>;
+
+/// Rebuild the DD rooted at `p` without the given edges
+template <class Config>
+vEdge removeEdges(const vNode* p, const EdgeSet& removed,
+                  std::unordered_map<const vNode*, vEdge>& rebuilt,
+                  Package<Config>& dd) {
+  if (const auto it = rebuilt.find(p); it != rebuilt.end()) {
+    return it->second;
+  }
+  std::array<vEdge, RADIX> edges{};
+  for (std::size_t i = 0U; i < RADIX; ++i) {
+    const auto& e = p->e[i];
+    if (e.w.exactlyZero() || removed.count({p, i}) != 0U) {
+      edges[i] = vEdge::zero();
+    } else if (e.isTerminal()) {
+      edges[i] = e;
+    } else {
+      const auto child = removeEdges(e.p, removed, rebuilt, dd);
+      edges[i] = child.w.exactlyZero()
+                     ? vEdge::zero()
+                     : vEdge{child.p, dd.cn.lookup(e.w * child.w)};
+    }
+  }
+  const auto e = dd.makeDDNode(p->v, edges);
+  rebuilt.emplace(p, e);
+  return e;
+}
+} // namespace
+
+template <class Config>
+fp approximate(VectorDD& state, const fp budget, Package<Config>& dd) {
+  if (state.isTerminal() || budget <= 0.) {
+    return 1.;
+  }
+
+  std::unordered_map<const vNode*, fp> norms{};
+  const auto total = squaredNorm(state, norms);
+
+  // distribute the probability mass from the root to all nodes
+  std::vector<const vNode*> nodes{};
+  nodes.reserve(norms.size());
+  for (const auto& [node, norm] : norms) {
+    nodes.emplace_back(node);
+  }
+  std::sort(nodes.begin(), nodes.end(),
+            [](const vNode* lhs, const vNode* rhs) { return lhs->v > rhs->v; });
+  std::unordered_map<const vNode*, fp> mass{};
+  mass[state.p] = ComplexNumbers::mag2(state.w);
+
+  std::vector<std::tuple<fp, const vNode*, std::size_t>> contributions{};
+  for (const auto* node : nodes) {
+    const auto incoming = mass[node];
+    for (std::size_t i = 0U; i < RADIX; ++i) {
+      const auto& e = node->e[i];
+      if (e.w.exactlyZero()) {
+        continue;
+      }
+      const auto flow = incoming * ComplexNumbers::mag2(e.w);
+      if (e.isTerminal()) {
+        contributions.emplace_back(flow, node, i);
       } else {
-        // otherwise, we consider the output permutation for determining where
-        // to measure the qubits to
-        for (const auto& [qubit, bit] : qc->outputPermutation) {
-          measurement[qc->getNcbits() - 1U - bit] =
-              bitstring[bitstring.size() - 1U - qubit];
-        }
+        contributions.emplace_back(flow * norms.at(e.p), node, i);
+        mass[e.p] += flow;
       }
-      actualCounts[measurement] += count;
     }
-    return actualCounts;
   }
 
-  std::map<std::string, std::size_t> counts{};
+  // remove the least contributing edges within the budget
+  std::sort(contributions.begin(), contributions.end());
+  EdgeSet removed{};
+  fp removedMass = 0.;
+  for (const auto& [contribution, node, i] : contributions) {
+    if (removedMass + contribution > budget * total ||
+        removedMass + contribution >= total) {
+      break;
+    }
+    removedMass += contribution;
+    removed.emplace(node, i);
+  }
+  if (removed.empty()) {
+    return 1.;
+  }
 
-  for (std::size_t i = 0U; i < shots; i++) {
-    std::map<std::size_t, char> measurements{};
+  std::unordered_map<const vNode*, vEdge> rebuilt{};
+  const auto root = removeEdges(state.p, removed, rebuilt, dd);
+  auto approximated = vEdge{root.p, dd.cn.lookup(state.w * root.w)};
+  norms.clear();
+  const auto remaining = squaredNorm(approximated, norms);
+
+  // the removed amplitudes are projected out, i.e., the fidelity is the
+  // fraction of the probability mass that remains
+  approximated.w = dd.cn.lookup(static_cast<ComplexValue>(approximated.w) *
+                                std::sqrt(total / remaining));
+  dd.incRef(approximated);
+  dd.decRef(state);
+  state = approximated;
+  return remaining / total;
+}
 
-    auto permutation = qc->initialLayout;
-    auto e = in;
-    dd.incRef(e);
+template <class Config>
+VectorDD simulateApproximately(const QuantumComputation* qc,
+                               const VectorDD& in, Package<Config>& dd,
+                               const std::size_t nodeThreshold,
+                               const fp stepFidelity, fp& fidelity) {
+  fidelity = 1.;
+  auto threshold = nodeThreshold;
+  auto permutation = qc->initialLayout;
+  auto e = in;
+  dd.incRef(e);
 
-    for (const auto& op : *qc) {
-      if (const auto* nonunitary = dynamic_cast<NonUnitaryOperation*>(op.get());
-          nonunitary != nullptr) {
-        if (nonunitary->getType() == Measure) {
-          const auto& qubits = nonunitary->getTargets();
-          const auto& bits = nonunitary->getClassics();
-          for (std::size_t j = 0U; j < qubits.size(); ++j) {
-            measurements[bits.at(j)] = dd.measureOneCollapsing(
-                e, static_cast<Qubit>(permutation.at(qubits.at(j))), true, mt);
-          }
-          continue;
-        }
+  for (const auto& op : *qc) {
+    auto tmp = dd.multiply(getDD(op.get(), dd, permutation), e);
+    dd.incRef(tmp);
+    dd.decRef(e);
+    e = tmp;
 
-        if (nonunitary->getType() == Reset) {
-          const auto& qubits = nonunitary->getTargets();
-          for (const auto& qubit : qubits) {
-            auto bit = dd.measureOneCollapsing(
-                e, static_cast<Qubit>(permutation.at(qubit)), true, mt);
-            // apply an X operation whenever the measured result is one
-            if (bit == '1') {
-              const auto x =
-                  qc::StandardOperation(permutation.at(qubit), qc::X);
-              auto tmp = dd.multiply(getDD(&x, dd), e);
-              dd.incRef(tmp);
-              dd.decRef(e);
-              e = tmp;
-              dd.garbageCollect();
-            }
-          }
-          continue;
-        }
+    if (e.size() > threshold) {
+      fidelity *= approximate(e, 1. - stepFidelity, dd);
+      if (const auto size = e.size(); size > threshold) {
+        threshold = 2U * size;
       }
+    }
+    dd.garbageCollect();
+  }
 
-      if (const auto* classicControlled =
-              dynamic_cast<ClassicControlledOperation*>(op.get());
-          classicControlled != nullptr) {
-        const auto& controlRegister = classicControlled->getControlRegister();
-        const auto& expectedValue = classicControlled->getExpectedValue();
-        auto actualValue = 0ULL;
-        // determine the actual value from measurements
-        for (std::size_t j = 0; j < controlRegister.second; ++j) {
-          if (measurements[controlRegister.first + j] == '1') {
-            actualValue |= 1ULL << j;
-          }
-        }
+  // correct permutation if necessary
+  changePermutation(e, permutation, qc->outputPermutation, dd);
+  e = dd.reduceGarbage(e, qc->garbage);
 
-        // do not apply an operation if the value is not the expected one
-        if (actualValue != expectedValue) {
-          continue;
-        }
+  return e;
+}
+
+namespace {
+/**
+ * @brief y += w * m * x for the block of 2^level entries starting at x and y
+ * @details `w` already includes the weight of `m`. Levels above the root of
+ * `m` are identities and split the block into two independent halves.
+ */
+void accumulateDense(const mEdge& m, const std::size_t level,
+                     const std::complex<fp> w, const std::complex<fp>* x,
+                     std::complex<fp>* y) {
+  const auto dim = std::size_t{1} << level;
+  if (m.isTerminal()) {
+    // std::complex<fp> is layout-compatible with fp[2]. Spelling out the
+    // product avoids the NaN handling of complex multiplication, which keeps
+    // the compiler from vectorizing this loop.
+    const auto* xs = reinterpret_cast<const fp*>(x);
+    auto* ys = reinterpret_cast<fp*>(y);
+    const auto wr = w.real();
+    const auto wi = w.imag();
+    for (std::size_t i = 0U; i < 2U * dim; i += 2U) {
+      ys[i] += wr * xs[i] - wi * xs[i + 1U];
+      ys[i + 1U] += wr * xs[i + 1U] + wi * xs[i];
+    }
+    return;
+  }
+  const auto half = dim / 2U;
+  if (static_cast<std::size_t>(m.p->v) + 1U < level) {
+    accumulateDense(m, level - 1U, w, x, y);
+    accumulateDense(m, level - 1U, w, x + half, y + half);
+    return;
+  }
+  for (std::size_t row = 0U; row < RADIX; ++row) {
+    for (std::size_t col = 0U; col < RADIX; ++col) {
+      const auto& e = m.p->e[(RADIX * row) + col];
+      if (e.w.exactlyZero()) {
+        continue;
       }
+      accumulateDense(e, level - 1U, w * static_cast<std::complex<fp>>(e.w),
+                      x + (col * half), y + (row * half));
+    }
+  }
+}
+} // namespace
 
-      auto tmp = dd.multiply(getDD(op.get(), dd, permutation), e);
+void applyToDense(const mEdge& op, const std::size_t nqubits, const CVec& in,
+                  CVec& out) {
+  if (in.size() != (std::size_t{1} << nqubits)) {
+    throw std::invalid_argument(
+        "State vector must have a length of 2^nqubits.");
+  }
+  if (!op.isTerminal() && static_cast<std::size_t>(op.p->v) >= nqubits) {
+    throw std::invalid_argument("Matrix acts on more qubits than the state.");
+  }
+  out.assign(in.size(), 0.);
+  if (op.w.exactlyZero()) {
+    return;
+  }
+  accumulateDense(op, nqubits, static_cast<std::complex<fp>>(op.w), in.data(),
+                  out.data());
+}
+
+template <class Config>
+VectorDD simulateHybrid(const QuantumComputation* qc, const VectorDD& in,
+                        Package<Config>& dd,
+                        const HybridSimulationConfig& config,
+                        HybridSimulationStatistics& stats) {
+  stats = {};
+  const auto nqubits = qc->getNqubits();
+  const auto canGoDense =
+      nqubits > 0U && nqubits <= config.maxDenseQubits && nqubits < 64U;
+  const auto full = canGoDense ? static_cast<fp>(std::size_t{1} << nqubits)
+                               : std::numeric_limits<fp>::infinity();
+
+  auto permutation = qc->initialLayout;
+  auto e = in;
+  dd.incRef(e);
+  CVec dense{};
+  CVec scratch{};
+  bool isDense = false;
+  std::size_t sinceCheck = 0U;
+
+  for (const auto& op : *qc) {
+    // simply skip any non-unitary
+    if (!op->isUnitary()) {
+      continue;
+    }
+    const auto gate = getDD(op.get(), dd, permutation);
+
+    if (!isDense) {
+      auto tmp = dd.multiply(gate, e);
       dd.incRef(tmp);
       dd.decRef(e);
       e = tmp;
-
       dd.garbageCollect();
+
+      if (canGoDense && !e.isTerminal() &&
+          static_cast<std::size_t>(e.p->v) + 1U == nqubits &&
+          static_cast<fp>(e.size()) > config.denseRatio * full) {
+        dense.resize(std::size_t{1} << nqubits);
+        exportDenseVector(e, nqubits, dense.data());
+        dd.decRef(e);
+        e = vEdge::zero();
+        isDense = true;
+        sinceCheck = 0U;
+        ++stats.toDense;
+      }
+      continue;
     }
 
-    // reduce reference count of measured state
-    dd.decRef(e);
+    applyToDense(gate, nqubits, dense, scratch);
+    dense.swap(scratch);
+    ++stats.denseGates;
+    // the gate DDs are not referenced by anything
+    dd.garbageCollect();
 
-    std::string shot(qc->getNcbits(), '0');
-    for (const auto& [bit, value] : measurements) {
-      shot[qc->getNcbits() - bit - 1U] = value;
+    if (++sinceCheck < config.checkInterval) {
+      continue;
+    }
+    sinceCheck = 0U;
+    auto candidate = dd.makeStateFromVector(dense);
+    dd.incRef(candidate);
+    if (static_cast<fp>(candidate.size()) <= config.sparseRatio * full) {
+      e = candidate;
+      isDense = false;
+      CVec{}.swap(dense);
+      CVec{}.swap(scratch);
+      ++stats.toDD;
+    } else {
+      dd.decRef(candidate);
     }
-    counts[shot]++;
   }
 
-  return counts;
+  if (isDense) {
+    e = dd.makeStateFromVector(dense);
+    dd.incRef(e);
+  }
+
+  // correct permutation if necessary
+  changePermutation(e, permutation, qc->outputPermutation, dd);
+  e = dd.reduceGarbage(e, qc->garbage);
+
+  return e;
 }
 
 template <class Config>
@@ -426,6 +982,34 @@ template std::map<std::string, std::size_t>
 simulate<DDPackageConfig>(const QuantumComputation* qc, const VectorDD& in,
                           Package<DDPackageConfig>& dd, std::size_t shots,
                           std::size_t seed);
+template VectorDD simulate<DDPackageConfig>(const QuantumComputation* qc,
+                                           const VectorDD& in,
+                                           Package<DDPackageConfig>& dd,
+                                           const CheckpointConfig& checkpoint);
+template VectorDD
+resumeSimulation<DDPackageConfig>(const QuantumComputation* qc,
+                                  Package<DDPackageConfig>& dd,
+                                  const std::string& file,
+                                  const CheckpointConfig& checkpoint);
+template std::vector<VectorDD>
+simulateBatch<DDPackageConfig>(const QuantumComputation* qc,
+                               const std::vector<VectorDD>& inputs,
+                               Package<DDPackageConfig>& dd);
+template std::vector<std::map<std::string, std::size_t>>
+simulateBatch<DDPackageConfig>(const QuantumComputation* qc,
+                               const std::vector<VectorDD>& inputs,
+                               Package<DDPackageConfig>& dd, std::size_t shots,
+                               std::size_t seed);
+template fp approximate<DDPackageConfig>(VectorDD& state, fp budget,
+                                         Package<DDPackageConfig>& dd);
+template VectorDD simulateApproximately<DDPackageConfig>(
+    const QuantumComputation* qc, const VectorDD& in,
+    Package<DDPackageConfig>& dd, std::size_t nodeThreshold, fp stepFidelity,
+    fp& fidelity);
+template VectorDD simulateHybrid<DDPackageConfig>(
+    const QuantumComputation* qc, const VectorDD& in,
+    Package<DDPackageConfig>& dd, const HybridSimulationConfig& config,
+    HybridSimulationStatistics& stats);
 template void extractProbabilityVector<DDPackageConfig>(
     const QuantumComputation* qc, const VectorDD& in, SparsePVec& probVector,
     Package<DDPackageConfig>& dd);
@@ -41,6 +41,12 @@ double MemoryManagerStatistics<T>::getPeakUsedMemoryMiB() const noexcept {
   return static_cast<double>(peakNumUsed) * ENTRY_MEMORY_MIB;
 }
 
+template <typename T>
+double MemoryManagerStatistics<T>::getReservedMemoryMiB() const noexcept {
+  return static_cast<double>(numReservedBytes) /
+         static_cast<double>(1ULL << 20U);
+}
+
 template <typename T>
 void MemoryManagerStatistics<T>::trackUsedEntries(
     const std::size_t numEntries) noexcept {
@@ -64,11 +70,29 @@ void MemoryManagerStatistics<T>::trackReturnedEntry() noexcept {
   --numUsed;
 }
 
+template <typename T>
+void MemoryManagerStatistics<T>::trackReservedBytes(
+    const std::size_t numBytes) noexcept {
+  numReservedBytes += numBytes;
+  peakNumReservedBytes = std::max(peakNumReservedBytes, numReservedBytes);
+}
+
+template <typename T>
+void MemoryManagerStatistics<T>::trackReleasedChunk(
+    const std::size_t numEntries, const std::size_t numBytes) noexcept {
+  numAllocated -= numEntries;
+  numAvailableForReuse -= numEntries;
+  numReservedBytes -= numBytes;
+  ++numReleasedChunks;
+}
+
 template <typename T> void MemoryManagerStatistics<T>::reset() noexcept {
   numAllocations = 0U;
   numAllocated = 0U;
   numUsed = 0U;
   numAvailableForReuse = 0U;
+  numReservedBytes = 0U;
+  numReleasedChunks = 0U;
 }
 
 template <typename T>
@@ -81,12 +105,17 @@ nlohmann::basic_json<> MemoryManagerStatistics<T>::json() const {
   j["memory_allocated_MiB"] = getAllocatedMemoryMiB();
   j["memory_used_MiB"] = getUsedMemoryMiB();
   j["memory_used_MiB_peak"] = getPeakUsedMemoryMiB();
+  j["memory_reserved_MiB"] = getReservedMemoryMiB();
+  j["memory_reserved_MiB_peak"] =
+      static_cast<double>(peakNumReservedBytes) /
+      static_cast<double>(1ULL << 20U);
   j["num_allocated"] = numAllocated;
   j["num_allocations"] = numAllocations;
   j["num_available_for_reuse"] = numAvailableForReuse;
   j["num_available_for_reuse_peak"] = peakNumAvailableForReuse;
   j["num_available_from_chunks"] = getNumAvailableFromChunks();
   j["num_available_total"] = getTotalNumAvailable();
+  j["num_released_chunks"] = numReleasedChunks;
   j["num_used"] = numUsed;
   j["num_used_peak"] = peakNumUsed;
   j["usage_ratio"] = getUsageRatio();
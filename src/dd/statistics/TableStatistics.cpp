@@ -22,6 +22,29 @@ double TableStatistics::hitRatio() const noexcept {
   return static_cast<double>(hits) / static_cast<double>(lookups);
 }
 
+void TableStatistics::checkpoint() noexcept {
+  checkpointLookups = lookups;
+  checkpointHits = hits;
+}
+
+double TableStatistics::hitRatioSinceCheckpoint() const noexcept {
+  const auto recentLookups = lookups - checkpointLookups;
+  if (recentLookups == 0) {
+    return 1.;
+  }
+  return static_cast<double>(hits - checkpointHits) /
+         static_cast<double>(recentLookups);
+}
+
+double TableStatistics::hitRatioDelta() const noexcept {
+  if (checkpointLookups == 0 || lookups == checkpointLookups) {
+    return 0.;
+  }
+  const auto before = static_cast<double>(checkpointHits) /
+                      static_cast<double>(checkpointLookups);
+  return hitRatioSinceCheckpoint() - before;
+}
+
 double TableStatistics::colRatio() const noexcept {
   if (lookups == 0) {
     return 0.;
@@ -59,6 +82,10 @@ nlohmann::basic_json<> TableStatistics::json() const {
   j["lookups"] = lookups;
   j["inserts"] = inserts;
   j["hit_ratio"] = hitRatio();
+  if (checkpointLookups != 0) {
+    j["hit_ratio_since_checkpoint"] = hitRatioSinceCheckpoint();
+    j["hit_ratio_delta"] = hitRatioDelta();
+  }
   j["col_ratio"] = colRatio();
   j["load_factor"] = loadFactor();
   return j;
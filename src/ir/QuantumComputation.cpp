@@ -146,6 +146,39 @@ void QuantumComputation::import(std::istream& is, Format format) {
   initializeIOMapping();
 }
 
+void QuantumComputation::importStreaming(const std::string& filename,
+                                         OperationSink sink) {
+  operationSink = std::move(sink);
+  try {
+    import(filename);
+  } catch (...) {
+    operationSink = nullptr;
+    throw;
+  }
+  operationSink = nullptr;
+}
+
+void QuantumComputation::importStreaming(std::istream& is, Format format,
+                                         OperationSink sink) {
+  operationSink = std::move(sink);
+  try {
+    import(is, format);
+  } catch (...) {
+    operationSink = nullptr;
+    throw;
+  }
+  operationSink = nullptr;
+}
+
+void QuantumComputation::append(std::unique_ptr<Operation> op) {
+  if (!operationSink) {
+    ops.emplace_back(std::move(op));
+    return;
+  }
+  streamedQubits.merge(op->getUsedQubits());
+  operationSink(std::move(op));
+}
+
 void QuantumComputation::initializeIOMapping() {
   // if no initial layout was found during parsing the identity mapping is
   // assumed
@@ -674,6 +707,9 @@ void QuantumComputation::dump(std::ostream& of, Format format) const {
 }
 
 bool QuantumComputation::isIdleQubit(const Qubit physicalQubit) const {
+  if (streamedQubits.count(physicalQubit) != 0U) {
+    return false;
+  }
   return !std::any_of(
       ops.cbegin(), ops.cend(),
       [&physicalQubit](const auto& op) { return op->actsOn(physicalQubit); });
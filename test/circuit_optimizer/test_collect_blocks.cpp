@@ -193,4 +193,18 @@ TEST(CollectBlocks, handleCompoundOperation2) {
   EXPECT_TRUE(qc.front()->isCompoundOperation());
 }
 
+TEST(CollectBlocks, mergeBlocksKeepsOrder) {
+  QuantumComputation qc(2);
+  qc.x(1);
+  qc.reset(0);
+  qc.h(1);
+  qc.h(0);
+  qc.cx(1, 0);
+  qc::CircuitOptimizer::collectBlocks(qc, 2);
+  // the H gate on qubit 0 must not be moved in front of the reset
+  EXPECT_EQ(qc.size(), 2);
+  EXPECT_TRUE(qc.front()->isNonUnitaryOperation());
+  EXPECT_TRUE(qc.back()->isCompoundOperation());
+  EXPECT_EQ(dynamic_cast<qc::CompoundOperation*>(qc.back().get())->size(), 4);
+}
 } // namespace qc
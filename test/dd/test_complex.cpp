@@ -1,4 +1,5 @@
 #include "dd/ComplexNumbers.hpp"
+#include "dd/ConcurrentRealNumberUniqueTable.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/Export.hpp"
 #include "dd/MemoryManager.hpp"
@@ -13,6 +14,7 @@
 #include <iostream>
 #include <limits>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 using namespace dd;
@@ -500,6 +502,83 @@ TEST_F(CNTest, DoubleHitAcrossBuckets) {
   EXPECT_EQ(tnum4->value, num1);
 }
 
+TEST(DDComplexTest, ConcurrentTableMatchesSequentialSemantics) {
+  MemoryManager<RealNumber> mm{};
+  ConcurrentRealNumberUniqueTable ct{mm};
+  const auto nbucket =
+      static_cast<fp>(ConcurrentRealNumberUniqueTable::NBUCKET - 1U);
+
+  auto* a = ct.lookup(0.3);
+  EXPECT_EQ(ct.lookup(0.3 + 0.5 * RealNumber::eps), a);
+  EXPECT_EQ(ct.lookup(-0.3), RealNumber::getNegativePointer(a));
+  EXPECT_EQ(ct.lookup(1e-16), &constants::zero);
+  EXPECT_EQ(ct.lookup(1.), &constants::one);
+
+  // a value right below a bucket border is found from the bucket above
+  const fp border = 8191.5 / nbucket;
+  auto* below = ct.lookup(border - 0.4 * RealNumber::eps);
+  ASSERT_NE(ConcurrentRealNumberUniqueTable::hash(below->value),
+            ConcurrentRealNumberUniqueTable::hash(border + 0.4 *
+                                                  RealNumber::eps));
+  EXPECT_EQ(ct.lookup(border + 0.4 * RealNumber::eps), below);
+
+  // the closest of two matching entries is returned
+  auto* far = ct.lookup(border - 2. * RealNumber::eps);
+  EXPECT_NE(far, below);
+  EXPECT_EQ(ct.lookup(border - 1.6 * RealNumber::eps), far);
+  EXPECT_EQ(ct.lookup(border - 0.9 * RealNumber::eps), below);
+
+  // 0.5 plus the three values above
+  EXPECT_EQ(ct.getNumEntries(), 4U);
+  ct.incRef(a);
+  EXPECT_EQ(ct.garbageCollect(true), 2U);
+  EXPECT_EQ(ct.lookup(0.3), a);
+  ct.decRef(a);
+}
+
+TEST(DDComplexTest, ConcurrentTableLookups) {
+  MemoryManager<RealNumber> mm{};
+  ConcurrentRealNumberUniqueTable ct{mm};
+  const auto nbucket =
+      static_cast<fp>(ConcurrentRealNumberUniqueTable::NBUCKET - 1U);
+
+  // few distinct values (many collisions) including values at bucket borders
+  std::vector<fp> values{};
+  for (std::size_t i = 1U; i < 200U; ++i) {
+    values.emplace_back(static_cast<fp>(i) / 1000.);
+    values.emplace_back((static_cast<fp>(i) + 0.5) / nbucket);
+  }
+  constexpr std::size_t numThreads = 8U;
+  std::vector<std::vector<RealNumber*>> results(
+      numThreads, std::vector<RealNumber*>(values.size()));
+  std::vector<std::thread> threads{};
+  for (std::size_t t = 0U; t < numThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      // every thread perturbs the values within the tolerance and starts at a
+      // different position to provoke concurrent inserts
+      const auto offset = static_cast<fp>(t) / numThreads - 0.5;
+      for (std::size_t k = 0U; k < values.size(); ++k) {
+        const auto i = (k + t * 17U) % values.size();
+        results[t][i] = ct.lookup(values[i] + offset * RealNumber::eps);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (std::size_t t = 1U; t < numThreads; ++t) {
+    EXPECT_EQ(results[t], results[0]);
+  }
+  for (std::size_t i = 0U; i < values.size(); ++i) {
+    EXPECT_NEAR(results[0][i]->value, values[i], RealNumber::eps);
+  }
+  EXPECT_EQ(ct.getNumEntries(), values.size() + 1U);
+  const auto stats = ct.getStats();
+  EXPECT_EQ(stats.lookups, numThreads * values.size() + 1U);
+  EXPECT_EQ(stats.inserts, values.size() + 1U);
+}
+
 TEST_F(CNTest, complexRefCount) {
   auto value = cn.lookup(0.2, 0.2);
   EXPECT_EQ(value.r->ref, 0);
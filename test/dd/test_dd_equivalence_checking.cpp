@@ -0,0 +1,214 @@
+#include "circuit_optimizer/CircuitOptimizer.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/EquivalenceChecking.hpp"
+#include "dd/Package.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+using namespace qc;
+
+namespace {
+QuantumComputation randomCircuit(const std::size_t nqubits,
+                                 const std::size_t ngates,
+                                 const std::size_t seed) {
+  std::mt19937_64 mt(seed);
+  std::uniform_int_distribution<Qubit> qubit(
+      0U, static_cast<Qubit>(nqubits - 1U));
+  std::uniform_int_distribution<int> gate(0, 5);
+  std::uniform_real_distribution<dd::fp> angle(0., 2. * dd::PI);
+
+  QuantumComputation qc(nqubits);
+  for (std::size_t i = 0U; i < ngates; ++i) {
+    const auto t = qubit(mt);
+    auto c = qubit(mt);
+    while (c == t) {
+      c = qubit(mt);
+    }
+    switch (gate(mt)) {
+    case 0:
+      qc.h(t);
+      break;
+    case 1:
+      qc.t(t);
+      break;
+    case 2:
+      qc.rz(angle(mt), t);
+      break;
+    case 3:
+      qc.cx(c, t);
+      break;
+    case 4:
+      qc.cz(c, t);
+      break;
+    default:
+      qc.swap(c, t);
+      break;
+    }
+  }
+  return qc;
+}
+} // namespace
+
+TEST(DDEquivalenceChecking, EquivalentCircuits) {
+  QuantumComputation qc1(3U);
+  qc1.h(0);
+  qc1.cx(0, 1);
+  qc1.swap(1, 2);
+  qc1.t(2);
+
+  // CNOT via CZ, SWAP via CNOTs
+  QuantumComputation qc2(3U);
+  qc2.h(0);
+  qc2.h(1);
+  qc2.cz(0, 1);
+  qc2.h(1);
+  qc2.cx(1, 2);
+  qc2.cx(2, 1);
+  qc2.cx(1, 2);
+  qc2.t(2);
+
+  auto dd = std::make_unique<dd::Package<>>(3U);
+  const auto result = dd::checkEquivalence(&qc1, &qc2, *dd);
+  EXPECT_EQ(result.equivalence, dd::EquivalenceCriterion::Equivalent);
+  EXPECT_FALSE(result.earlyExit);
+  EXPECT_EQ(result.appliedGates1, qc1.size());
+  EXPECT_EQ(result.appliedGates2, qc2.size());
+  EXPECT_GT(result.peakNodes, 0U);
+  EXPECT_GT(result.peakActiveNodes, 0U);
+  EXPECT_GE(result.runtime, 0.);
+}
+
+TEST(DDEquivalenceChecking, EquivalentUpToGlobalPhase) {
+  QuantumComputation qc1(2U);
+  qc1.h(0);
+  qc1.cx(0, 1);
+  qc1.p(dd::PI, 1);
+
+  // RZ(pi) = -i P(pi)
+  QuantumComputation qc2(2U);
+  qc2.h(0);
+  qc2.cx(0, 1);
+  qc2.rz(dd::PI, 1);
+
+  auto dd = std::make_unique<dd::Package<>>(2U);
+  const auto result = dd::checkEquivalence(&qc1, &qc2, *dd);
+  EXPECT_EQ(result.equivalence,
+            dd::EquivalenceCriterion::EquivalentUpToGlobalPhase);
+}
+
+TEST(DDEquivalenceChecking, NonEquivalentCircuitsExitEarly) {
+  QuantumComputation qc1(4U);
+  qc1.x(0);
+  QuantumComputation qc2(4U);
+  for (std::size_t i = 0U; i < 10U; ++i) {
+    for (Qubit q = 1U; q < 3U; ++q) {
+      qc1.h(q);
+      qc1.cx(q, q + 1);
+      qc2.h(q);
+      qc2.cx(q, q + 1);
+    }
+  }
+
+  auto dd = std::make_unique<dd::Package<>>(4U);
+  auto result = dd::checkEquivalence(&qc1, &qc2, *dd);
+  EXPECT_EQ(result.equivalence, dd::EquivalenceCriterion::NotEquivalent);
+  EXPECT_TRUE(result.earlyExit);
+  EXPECT_LT(result.appliedGates1 + result.appliedGates2,
+            qc1.size() + qc2.size());
+
+  dd::EquivalenceCheckingConfig config{};
+  config.earlyExit = false;
+  result = dd::checkEquivalence(&qc1, &qc2, *dd, config);
+  EXPECT_EQ(result.equivalence, dd::EquivalenceCriterion::NotEquivalent);
+  EXPECT_FALSE(result.earlyExit);
+  EXPECT_EQ(result.appliedGates1, qc1.size());
+  EXPECT_EQ(result.appliedGates2, qc2.size());
+}
+
+TEST(DDEquivalenceChecking, OptimizedRandomCircuits) {
+  constexpr std::size_t nqubits = 6U;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  for (std::size_t seed = 0U; seed < 5U; ++seed) {
+    const auto qc1 = randomCircuit(nqubits, 100U, seed);
+    auto qc2 = qc1;
+    CircuitOptimizer::swapReconstruction(qc2);
+    CircuitOptimizer::singleQubitGateFusion(qc2);
+    CircuitOptimizer::removeIdentities(qc2);
+
+    for (const auto reorder : {false, true}) {
+      dd::EquivalenceCheckingConfig config{};
+      config.reorder = reorder;
+      config.reorderThreshold = 8U;
+      auto result = dd::checkEquivalence(&qc1, &qc2, *dd, config);
+      EXPECT_NE(result.equivalence, dd::EquivalenceCriterion::NotEquivalent);
+
+      // prepend an additional gate
+      QuantumComputation qc3(nqubits);
+      qc3.x(static_cast<Qubit>(seed % nqubits));
+      for (const auto& op : qc2) {
+        qc3.emplace_back(op->clone());
+      }
+      result = dd::checkEquivalence(&qc1, &qc3, *dd, config);
+      EXPECT_EQ(result.equivalence, dd::EquivalenceCriterion::NotEquivalent);
+    }
+  }
+}
+
+TEST(DDEquivalenceChecking, Reordering) {
+  // pairs (i, i + 4) are entangled, which is a bad order for the DD
+  constexpr std::size_t nqubits = 8U;
+  QuantumComputation qc1(nqubits);
+  for (Qubit i = 0U; i < 4U; ++i) {
+    qc1.h(i);
+    qc1.cx(i, i + 4);
+    qc1.t(i + 4);
+  }
+  for (Qubit i = 0U; i < 4U; ++i) {
+    qc1.rz(0.3 * static_cast<dd::fp>(i + 1), i);
+    qc1.cx(i + 4, i);
+  }
+  auto inverse = qc1;
+  inverse.invert();
+
+  // G G^-1 G forces a large intermediate DD
+  QuantumComputation qc2(nqubits);
+  QuantumComputation qc3(nqubits);
+  for (const auto* part : {&qc1, &inverse, &qc1}) {
+    for (const auto& op : *part) {
+      qc2.emplace_back(op->clone());
+      qc3.emplace_back(op->clone());
+    }
+    if (part == &inverse) {
+      qc3.z(3);
+    }
+  }
+
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  dd::EquivalenceCheckingConfig config{};
+  const auto plain = dd::checkEquivalence(&qc1, &qc2, *dd, config);
+  EXPECT_EQ(plain.equivalence, dd::EquivalenceCriterion::Equivalent);
+  EXPECT_EQ(plain.reorderings, 0U);
+
+  config.reorder = true;
+  config.reorderThreshold = 4U;
+  const auto sifted = dd::checkEquivalence(&qc1, &qc2, *dd, config);
+  EXPECT_EQ(sifted.equivalence, dd::EquivalenceCriterion::Equivalent);
+  EXPECT_GT(sifted.reorderings, 0U);
+  EXPECT_LT(sifted.peakNodes, plain.peakNodes);
+
+  config.earlyExit = false;
+  const auto result = dd::checkEquivalence(&qc1, &qc3, *dd, config);
+  EXPECT_EQ(result.equivalence, dd::EquivalenceCriterion::NotEquivalent);
+}
+
+TEST(DDEquivalenceChecking, DifferentNumberOfQubits) {
+  QuantumComputation qc1(2U);
+  QuantumComputation qc2(3U);
+  auto dd = std::make_unique<dd::Package<>>(3U);
+  EXPECT_THROW(dd::checkEquivalence(&qc1, &qc2, *dd), std::invalid_argument);
+}
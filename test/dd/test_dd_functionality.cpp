@@ -1,5 +1,6 @@
 #include "Definitions.hpp"
 #include "circuit_optimizer/CircuitOptimizer.hpp"
+#include "dd/Checkpoint.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/FunctionalityConstruction.hpp"
 #include "dd/Operations.hpp"
@@ -13,13 +14,17 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <memory>
 #include <random>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <vector>
 
 using namespace qc;
@@ -514,3 +519,496 @@ TEST_F(DDFunctionality, FuseSingleQubitGatesAcrossOtherGates) {
   EXPECT_EQ(qc.getNops(), 2);
   EXPECT_EQ(e, f);
 }
+
+TEST_F(DDFunctionality, BuildFunctionalityFused) {
+  QuantumComputation qc(nqubits);
+  for (Qubit q = 0U; q < nqubits; ++q) {
+    qc.h(q);
+    qc.t(q);
+  }
+  qc.cx(0, 1);
+  qc.rz(0.3, 1);
+  qc.cx(2, 3);
+  qc.mcx({0, 1}, 2);
+  qc.swap(1, 3);
+  qc.cp(0.7, 3, 0);
+  qc.sx(2);
+
+  e = buildFunctionality(&qc, *dd);
+  for (const std::size_t blockSize : {1U, 2U, 3U, 4U}) {
+    const auto f = buildFunctionalityFused(&qc, *dd, blockSize);
+    EXPECT_EQ(e, f) << "block size " << blockSize;
+    dd->decRef(f);
+  }
+  // the circuit itself is left untouched
+  EXPECT_EQ(qc.size(), 2U * nqubits + 7U);
+}
+
+TEST_F(DDFunctionality, BuildFunctionalityParallel) {
+  QuantumComputation qc(nqubits);
+  for (Qubit q = 0U; q < nqubits; ++q) {
+    qc.h(q);
+  }
+  qc.cx(0, 1);
+  qc.swap(0, 2);
+  qc.t(0);
+  qc.mcx({1, 2}, 3);
+  qc.rx(0.4, 2);
+  qc.swap(1, 3);
+  qc.cz(3, 0);
+  qc.ry(-1.2, 1);
+  qc.cp(0.7, 2, 1);
+
+  e = buildFunctionality(&qc, *dd);
+  for (const std::size_t numThreads : {1U, 2U, 3U, 5U, 64U}) {
+    const auto f = buildFunctionalityParallel(&qc, *dd, numThreads);
+    EXPECT_EQ(e, f) << numThreads << " threads";
+    dd->decRef(f);
+  }
+}
+
+TEST_F(DDFunctionality, BuildFunctionalityStreaming) {
+  const std::string real = ".numvars 4\n"
+                           ".variables a b c d\n"
+                           ".constants --01\n"
+                           ".garbage --11\n"
+                           ".begin\n"
+                           "h1 a\n"
+                           "t2 a b\n"
+                           "f2 a c\n"
+                           "v c d\n"
+                           "t3 a d c\n"
+                           "rz1:4 b\n"
+                           ".end\n";
+  const std::string qasm = "OPENQASM 3.0;\n"
+                           "include \"stdgates.inc\";\n"
+                           "qubit[2] q;\n"
+                           "h q[0];\n"
+                           "cx q[0], q[1];\n"
+                           "swap q[0], q[1];\n"
+                           "qubit[2] r;\n"
+                           "cx q[1], r[0];\n"
+                           "rz(0.3) r[1];\n"
+                           "swap q[0], r[1];\n"
+                           "ccx r[1], q[1], r[0];\n";
+
+  for (const auto& [source, format] :
+       {std::pair{real, Format::Real}, std::pair{qasm, Format::OpenQASM3}}) {
+    std::stringstream ss{source};
+    QuantumComputation qc{};
+    qc.import(ss, format);
+    const auto f = buildFunctionality(&qc, *dd);
+    for (const bool concurrent : {false, true}) {
+      std::stringstream is{source};
+      // a capacity of one forces the parser to wait for the builder
+      const auto g = buildFunctionalityStreaming(is, format, *dd, concurrent, 1U);
+      EXPECT_EQ(f, g) << (concurrent ? "concurrent" : "sequential");
+      dd->decRef(g);
+    }
+    dd->decRef(f);
+  }
+}
+
+TEST_F(DDFunctionality, BuildFunctionalityStreamingNonUnitary) {
+  const std::string qasm = "OPENQASM 3.0;\n"
+                           "include \"stdgates.inc\";\n"
+                           "qubit[2] q;\n"
+                           "bit[1] c;\n"
+                           "h q[0];\n"
+                           "c[0] = measure q[0];\n"
+                           "h q[1];\n"
+                           "cx q[1], q[0];\n";
+  for (const bool concurrent : {false, true}) {
+    std::stringstream is{qasm};
+    EXPECT_THROW(buildFunctionalityStreaming(is, Format::OpenQASM3, *dd,
+                                             concurrent, 1U),
+                 qc::QFRException);
+  }
+}
+
+namespace {
+struct GateDDCacheConfig : public dd::DDPackageConfig {
+  static constexpr std::size_t GATE_DD_CACHE_SIZE = 3U;
+};
+
+// buildFunctionality is only instantiated for the predefined configurations
+template <class Config>
+MatrixDD buildWithGateCache(const QuantumComputation& qc,
+                            dd::Package<Config>& dd) {
+  auto e = dd.makeIdent();
+  for (const auto& op : qc) {
+    e = dd.multiply(dd::getDD(op.get(), dd), e);
+  }
+  return e;
+}
+} // namespace
+
+TEST(DDFunctionalityGateCache, RepeatedGatesAreCached) {
+  constexpr std::size_t nq = 4U;
+  QuantumComputation qc(nq);
+  for (std::size_t i = 0U; i < 10U; ++i) {
+    qc.mcx({0, 1}, 2);
+    qc.cx(2, 3);
+    qc.h(0);
+    qc.rz(0.25, 1);
+  }
+
+  auto dd = std::make_unique<dd::Package<GateDDCacheConfig>>(nq);
+  auto ref = std::make_unique<dd::Package<>>(nq);
+  const auto e = buildWithGateCache(qc, *dd);
+  const auto f = buildFunctionality(&qc, *ref);
+  EXPECT_EQ(e.getMatrix(nq), f.getMatrix(nq));
+
+  // four distinct gates compete for three slots in a round-robin pattern
+  const auto& stats = dd->gateDDCache.getStats();
+  EXPECT_EQ(stats.lookups, qc.size());
+  EXPECT_EQ(stats.numEntries, 3U);
+
+  // a cache holding all distinct gates only misses once per gate
+  auto large = std::make_unique<dd::Package<GateDDCacheConfig>>(nq);
+  QuantumComputation pattern(nq);
+  for (std::size_t i = 0U; i < 10U; ++i) {
+    pattern.mcx({0, 1}, 2);
+    pattern.cx(2, 3);
+    pattern.h(0);
+  }
+  std::ignore = buildWithGateCache(pattern, *large);
+  EXPECT_EQ(large->gateDDCache.getStats().hits, pattern.size() - 3U);
+
+  // the same gate on permuted qubits is a different entry
+  Permutation perm{};
+  for (Qubit q = 0U; q < nq; ++q) {
+    perm[q] = nq - 1U - q;
+  }
+  const auto permuted = dd::getDD(pattern.at(2).get(), *large, perm);
+  EXPECT_EQ(permuted, large->makeGateDD(dd::H_MAT, 3));
+
+  // cached gates are pinned and survive garbage collection
+  large->garbageCollect(true);
+  EXPECT_GT(large->mUniqueTable.getNumEntries(), 0U);
+  EXPECT_EQ(dd::getDD(pattern.at(0).get(), *large),
+            large->makeGateDD(dd::X_MAT, Controls{0, 1}, 2));
+  large->clearGateDDCache();
+  large->garbageCollect(true);
+  EXPECT_EQ(large->mUniqueTable.getNumEntries(), 0U);
+}
+
+namespace {
+/// A circuit whose amplitudes are spread unevenly over all basis states
+QuantumComputation skewedCircuit(const std::size_t nqubits) {
+  QuantumComputation qc(nqubits);
+  for (Qubit q = 0U; q < nqubits; ++q) {
+    qc.ry(0.2 + 0.1 * static_cast<dd::fp>(q), q);
+  }
+  for (std::size_t layer = 0U; layer < 3U; ++layer) {
+    for (Qubit q = 0U; q + 1U < nqubits; ++q) {
+      qc.cx(q, q + 1U);
+      qc.ry(0.3 * static_cast<dd::fp>(layer + 1U), q + 1U);
+      qc.rz(0.7 * static_cast<dd::fp>(q + 1U), q);
+    }
+  }
+  return qc;
+}
+} // namespace
+
+TEST(DDApproximation, ApproximateState) {
+  constexpr std::size_t nqubits = 6U;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  const auto qc = skewedCircuit(nqubits);
+  const auto exact = simulate(&qc, dd->makeZeroState(nqubits), *dd);
+
+  // a budget of zero leaves the state untouched
+  auto approximated = exact;
+  dd->incRef(approximated);
+  EXPECT_EQ(dd::approximate(approximated, 0., *dd), 1.);
+  EXPECT_EQ(approximated, exact);
+
+  const auto fidelity = dd::approximate(approximated, 0.1, *dd);
+  EXPECT_LT(fidelity, 1.);
+  EXPECT_GE(fidelity, 0.9);
+  EXPECT_LT(approximated.size(), exact.size());
+  EXPECT_NEAR(dd->fidelity(exact, approximated), fidelity, 1e-6);
+  EXPECT_NEAR(dd->fidelity(approximated, approximated), 1., 1e-6);
+}
+
+TEST(DDApproximation, EqualContributionsAreRemovedDeterministically) {
+  constexpr std::size_t nqubits = 3U;
+  // the second package allocates its nodes in a different order
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  auto other = std::make_unique<dd::Package<>>(nqubits);
+  const auto filler =
+      other->makeBasisState(nqubits, std::vector<bool>{true, false, true});
+  other->incRef(filler);
+
+  for (auto* package : {dd.get(), other.get()}) {
+    auto ghz = package->makeGHZState(nqubits);
+    package->incRef(ghz);
+    // both branches of the GHZ state contribute the same, so exactly one of
+    // them fits into the budget and the one of |000> is removed first
+    EXPECT_NEAR(dd::approximate(ghz, 0.5, *package), 0.5, 1e-10);
+    EXPECT_NEAR(std::abs(ghz.getValueByIndex(0U)), 0., 1e-10);
+    EXPECT_NEAR(std::abs(ghz.getValueByIndex(7U)), 1., 1e-10);
+    package->decRef(ghz);
+  }
+}
+
+TEST(DDApproximation, SimulateApproximately) {
+  constexpr std::size_t nqubits = 10U;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  const auto qc = skewedCircuit(nqubits);
+  const auto exact = simulate(&qc, dd->makeZeroState(nqubits), *dd);
+
+  dd::fp fidelity = 0.;
+  const auto approximated = dd::simulateApproximately(
+      &qc, dd->makeZeroState(nqubits), *dd, 16U, 0.99, fidelity);
+  EXPECT_LT(fidelity, 1.);
+  EXPECT_GT(fidelity, 0.);
+  EXPECT_LT(approximated.size(), exact.size());
+  EXPECT_NEAR(dd->fidelity(approximated, approximated), 1., 1e-6);
+
+  // without approximations, the result is exact
+  const auto full = dd::simulateApproximately(
+      &qc, dd->makeZeroState(nqubits), *dd, 1U << nqubits, 0.99, fidelity);
+  EXPECT_EQ(fidelity, 1.);
+  EXPECT_EQ(full, exact);
+}
+
+TEST(DDHybridSimulation, ApplyToDenseMatchesMultiply) {
+  constexpr std::size_t nqubits = 5U;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  const auto prep = skewedCircuit(nqubits);
+  const auto state = simulate(&prep, dd->makeZeroState(nqubits), *dd);
+  const auto vec = state.getVector();
+
+  QuantumComputation qc(nqubits);
+  qc.h(2);
+  qc.cx(4, 1);
+  qc.cx(0, 3);
+  qc.mcx({1, 4}, 2);
+  qc.rzz(0.4, 0, 3);
+  qc.swap(1, 4);
+  qc.u(0.1, 0.2, 0.3, 4);
+  for (const auto& op : qc) {
+    const auto gate = dd::getDD(op.get(), *dd);
+    const auto expected = dd->multiply(gate, state).getVector();
+    dd::CVec actual{};
+    dd::applyToDense(gate, nqubits, vec, actual);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0U; i < actual.size(); ++i) {
+      EXPECT_NEAR(std::abs(actual[i] - expected[i]), 0., 1e-10)
+          << op->getName() << " at " << i;
+    }
+  }
+
+  dd::CVec out{};
+  EXPECT_THROW(dd::applyToDense(dd->makeIdent(), nqubits + 1U, vec, out),
+               std::invalid_argument);
+}
+
+TEST(DDHybridSimulation, SwitchesToDenseAndBack) {
+  constexpr std::size_t nqubits = 8U;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  auto qc = skewedCircuit(nqubits);
+  qc.swap(0, nqubits - 1U);
+  const auto exact = simulate(&qc, dd->makeZeroState(nqubits), *dd);
+
+  // the skewed circuit quickly produces a DD with almost 2^n nodes
+  dd::HybridSimulationConfig config{};
+  config.denseRatio = 0.1;
+  config.sparseRatio = 0.1;
+  config.checkInterval = 4U;
+  dd::HybridSimulationStatistics stats{};
+  const auto hybrid = dd::simulateHybrid(&qc, dd->makeZeroState(nqubits),
+                                         *dd, config, stats);
+  EXPECT_EQ(stats.toDense, 1U);
+  EXPECT_GT(stats.denseGates, 0U);
+  EXPECT_NEAR(dd->fidelity(exact, hybrid), 1., 1e-9);
+
+  // uncomputing the state makes it compressible again
+  auto inverse = qc;
+  inverse.invert();
+  for (const auto& op : inverse) {
+    qc.emplace_back(op->clone());
+  }
+  const auto uncomputed = dd::simulateHybrid(
+      &qc, dd->makeZeroState(nqubits), *dd, config, stats);
+  EXPECT_EQ(stats.toDD, 1U);
+  EXPECT_NEAR(dd->fidelity(dd->makeZeroState(nqubits), uncomputed), 1.,
+              1e-9);
+
+  // without switching, the hybrid simulation is the plain DD simulation
+  config.denseRatio = 1.;
+  EXPECT_EQ(dd::simulateHybrid(&qc, dd->makeZeroState(nqubits), *dd, config,
+                               stats),
+            simulate(&qc, dd->makeZeroState(nqubits), *dd));
+  EXPECT_EQ(stats.toDense, 0U);
+  EXPECT_EQ(stats.denseGates, 0U);
+}
+
+TEST(DDBatchSimulation, MatchesSingleSimulations) {
+  constexpr std::size_t nqubits = 4U;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  auto qc = skewedCircuit(nqubits);
+  qc.swap(0, nqubits - 1U);
+
+  std::vector<dd::VectorDD> inputs{};
+  for (std::size_t i = 0U; i < (1U << nqubits); ++i) {
+    std::vector<bool> bits(nqubits);
+    for (std::size_t q = 0U; q < nqubits; ++q) {
+      bits[q] = ((i >> q) & 1U) != 0U;
+    }
+    inputs.emplace_back(dd->makeBasisState(nqubits, bits));
+    dd->incRef(inputs.back());
+  }
+  const auto outputs = dd::simulateBatch(&qc, inputs, *dd);
+  ASSERT_EQ(outputs.size(), inputs.size());
+  for (std::size_t i = 0U; i < inputs.size(); ++i) {
+    const auto single = simulate(&qc, inputs[i], *dd);
+    EXPECT_NEAR(dd->fidelity(single, outputs[i]), 1., 1e-9);
+    // a unitary maps orthogonal inputs to orthogonal outputs
+    EXPECT_NEAR(dd->fidelity(outputs[0], outputs[i]), i == 0U ? 1. : 0.,
+                1e-9);
+  }
+
+  auto measured = qc;
+  measured.measureAll();
+  constexpr std::size_t shots = 1000U;
+  const auto counts = dd::simulateBatch(&measured, inputs, *dd, shots, 42U);
+  ASSERT_EQ(counts.size(), inputs.size());
+  for (std::size_t i = 0U; i < inputs.size(); ++i) {
+    EXPECT_EQ(counts[i], simulate(&measured, inputs[i], *dd, shots, 42U));
+  }
+
+  measured.reset(0);
+  EXPECT_THROW(std::ignore = dd::simulateBatch(&measured, inputs, *dd, shots),
+               std::invalid_argument);
+}
+
+TEST(DDCheckpoint, ResumeFunctionality) {
+  constexpr std::size_t nqubits = 5U;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  auto qc = skewedCircuit(nqubits);
+  qc.swap(1, 3);
+  qc.h(1);
+  const auto expected = buildFunctionality(&qc, *dd);
+  const auto expectedMatrix = expected.getMatrix(nqubits);
+  const auto checkResult = [&](const qc::MatrixDD& result) {
+    const auto matrix = result.getMatrix(nqubits);
+    for (std::size_t i = 0U; i < matrix.size(); ++i) {
+      for (std::size_t j = 0U; j < matrix.size(); ++j) {
+        EXPECT_NEAR(std::abs(matrix[i][j] - expectedMatrix[i][j]), 0., 1e-9);
+      }
+    }
+  };
+  const auto file =
+      (std::filesystem::temp_directory_path() / "mqt_core_functionality.ckpt")
+          .string();
+
+  // writing checkpoints does not change the result
+  const dd::CheckpointConfig config{file, 4U, 0.};
+  checkResult(buildFunctionality(&qc, *dd, config));
+  EXPECT_TRUE(std::filesystem::exists(file));
+
+  // resume from a checkpoint taken in the middle of the circuit (after the
+  // swap, which changed the permutation)
+  const auto middle = qc.size() - 1U;
+  auto e = dd->makeIdent();
+  dd->incRef(e);
+  auto permutation = qc.initialLayout;
+  for (std::size_t i = 0U; i < middle; ++i) {
+    auto tmp = dd->multiply(dd::getDD(qc.at(i).get(), *dd, permutation), e);
+    dd->incRef(tmp);
+    dd->decRef(e);
+    e = tmp;
+  }
+  EXPECT_NE(permutation, qc.initialLayout);
+  dd::writeCheckpoint(file, e, middle, qc.size(), permutation);
+  dd->decRef(e);
+  checkResult(dd::resumeFunctionality(&qc, *dd, file));
+
+  // resuming can write further checkpoints to the same file
+  checkResult(dd::resumeFunctionality(&qc, *dd, file, config));
+
+  auto other = qc;
+  other.x(0);
+  EXPECT_THROW(std::ignore = dd::resumeFunctionality(&other, *dd, file),
+               std::invalid_argument);
+  EXPECT_THROW(std::ignore = dd::resumeSimulation(&qc, *dd, file),
+               std::runtime_error);
+  std::filesystem::remove(file);
+  EXPECT_THROW(std::ignore = dd::resumeFunctionality(&qc, *dd, file),
+               std::invalid_argument);
+}
+
+TEST(DDCheckpoint, ResumeSimulation) {
+  constexpr std::size_t nqubits = 6U;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+  auto qc = skewedCircuit(nqubits);
+  qc.swap(0, 2);
+  const auto in = dd->makeZeroState(nqubits);
+  const auto expected = simulate(&qc, in, *dd);
+  const auto file =
+      (std::filesystem::temp_directory_path() / "mqt_core_simulation.ckpt")
+          .string();
+
+  // a time-based trigger that is due after every gate
+  const dd::CheckpointConfig config{file, 0U, 1e-9};
+  const auto result = simulate(&qc, in, *dd, config);
+  EXPECT_NEAR(dd->fidelity(result, expected), 1., 1e-9);
+
+  // every checkpoint, wherever the main loop was, resumes to the same state
+  const auto checkpoint = dd::readCheckpoint<dd::vNode>(file, *dd);
+  EXPECT_GT(checkpoint.next, 0U);
+  EXPECT_LE(checkpoint.next, qc.size());
+  EXPECT_EQ(checkpoint.circuitSize, qc.size());
+  dd->decRef(checkpoint.state);
+  EXPECT_NEAR(dd->fidelity(dd::resumeSimulation(&qc, *dd, file), expected), 1.,
+              1e-9);
+
+  // checkpoints are written in the background and counted once they finished
+  {
+    dd::Checkpointer<dd::DDPackageConfig, dd::vNode> checkpointer(
+        *dd, {file, 1U, 0.}, qc.size());
+    for (std::size_t i = 1U; i <= qc.size(); ++i) {
+      checkpointer.step(in, i, qc.initialLayout);
+    }
+    checkpointer.finish();
+    EXPECT_GE(checkpointer.written(), 1U);
+  }
+  EXPECT_EQ(dd::readCheckpoint<dd::vNode>(file, *dd).state, in);
+  std::filesystem::remove(file);
+}
+
+TEST(DDDynamicSimulation, BranchesShareMeasurementHistories) {
+  // c0 = c1 by construction, c2 is uniformly random
+  QuantumComputation qc(3U, 3U);
+  qc.h(0);
+  qc.measure(0, 0U);
+  qc.classicControlled(qc::X, 1, {0, 1U}, 1U);
+  qc.h(2);
+  qc.measure(1, 1U);
+  qc.measure(2, 2U);
+  // a reset makes the circuit dynamic even after the last measurement
+  qc.reset(2);
+
+  constexpr std::size_t shots = 10000U;
+  auto dd = std::make_unique<dd::Package<>>(qc.getNqubits());
+  const auto counts =
+      simulate(&qc, dd->makeZeroState(qc.getNqubits()), *dd, shots, 42U);
+
+  std::size_t total = 0U;
+  for (const auto& [bits, count] : counts) {
+    EXPECT_EQ(bits[1], bits[2]);
+    // four outcomes with probability 1/4 each (5 standard deviations)
+    EXPECT_NEAR(static_cast<double>(count), shots / 4., 220.);
+    total += count;
+  }
+  EXPECT_EQ(counts.size(), 4U);
+  EXPECT_EQ(total, shots);
+
+  // the result is reproducible for a fixed seed
+  EXPECT_EQ(simulate(&qc, dd->makeZeroState(qc.getNqubits()), *dd, shots, 42U),
+            counts);
+  EXPECT_TRUE(
+      simulate(&qc, dd->makeZeroState(qc.getNqubits()), *dd, 0U, 42U).empty());
+}
@@ -296,6 +296,39 @@ TEST_F(DDNoiseFunctionalityTest, StochSimulateAdder4IdentityError) {
   EXPECT_NEAR(measSummary["1111"], 0., tolerance);
 }
 
+TEST_F(DDNoiseFunctionalityTest, StochSimulateAdder4Parallel) {
+  constexpr std::size_t shotsPerTrajectory = 10U;
+  const auto histogram = dd::simulateStochasticTrajectories(
+      qc, stochRuns, shotsPerTrajectory, 0.01, 0.02, 2., "APDI", 42U, 4U);
+
+  std::size_t total = 0U;
+  for (const auto& [outcome, count] : histogram) {
+    total += count;
+  }
+  ASSERT_EQ(total, stochRuns * shotsPerTrajectory);
+  const auto shots = static_cast<double>(total);
+  const double tolerance = 0.1;
+  EXPECT_NEAR(static_cast<double>(histogram.at(0b0000U)) / shots,
+              0.09693321927412533, tolerance);
+  EXPECT_NEAR(static_cast<double>(histogram.at(0b1001U)) / shots,
+              0.41458550719988047, tolerance);
+
+  // trajectories are seeded independently of the worker executing them
+  EXPECT_EQ(dd::simulateStochasticTrajectories(qc, stochRuns,
+                                               shotsPerTrajectory, 0.01, 0.02,
+                                               2., "APDI", 42U, 1U),
+            histogram);
+
+  const auto identity = dd::simulateStochasticTrajectories(
+      qc, stochRuns, 1U, 0.01, 0.02, 2., "I", 42U, 0U);
+  ASSERT_EQ(identity.size(), 1U);
+  EXPECT_EQ(identity.at(0b1001U), stochRuns);
+
+  EXPECT_THROW(dd::simulateStochasticTrajectories(qc, stochRuns, 1U, 0.01,
+                                                  0.02, 2., "APDX", 42U, 2U),
+               std::runtime_error);
+}
+
 TEST_F(DDNoiseFunctionalityTest, testingUsedQubits) {
   const std::size_t nqubits = 1;
   auto standardOp = StandardOperation(1, qc::Z);
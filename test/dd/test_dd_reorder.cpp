@@ -0,0 +1,323 @@
+#include "dd/DDCompletement.hpp"
+#include "dd/DDDefinitions.hpp"
+#include "dd/DDLinear.hpp"
+#include "dd/DDReorder.hpp"
+#include "dd/DDpackageConfig.hpp"
+#include "dd/FunctionalityConstruction.hpp"
+#include "dd/Package.hpp"
+#include "ir/Permutation.hpp"
+#include "ir/QuantumComputation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <queue>
+#include <random>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// A single reordering step as seen by the oracle: the pair of levels
+/// (`level`, `level - 1`) that is touched and the scheme that is applied.
+struct OracleStep {
+  dd::Qubit level;
+  dd::ReorderScheme scheme;
+};
+
+/**
+ * @brief Apply the index map induced by a reordering step to a single index
+ * @details For a node at level k with children at level k-1
+ *  - sifting swaps the bits k and k-1,
+ *  - the upper transformation maps x_k to x_k ^ x_{k-1},
+ *  - the lower transformation maps x_{k-1} to x_{k-1} ^ x_k.
+ * The same map is applied to row and column indices.
+ */
+std::size_t mapIndex(const std::size_t x, const OracleStep& step) {
+  const auto hi = static_cast<std::size_t>(step.level);
+  const auto lo = hi - 1U;
+  const auto bitHi = (x >> hi) & 1U;
+  const auto bitLo = (x >> lo) & 1U;
+  switch (step.scheme) {
+  case dd::SCHEME_SIFTING:
+    if (bitHi != bitLo) {
+      return x ^ ((1ULL << hi) | (1ULL << lo));
+    }
+    return x;
+  case dd::SCHEME_LTRANS_UPPER:
+    return x ^ (bitLo << hi);
+  case dd::SCHEME_LTRANS_LOWER:
+    return x ^ (bitHi << lo);
+  default:
+    return x;
+  }
+}
+
+/// Compute M' with M'[f(i)][f(j)] = M[i][j] for the map f of the given step.
+dd::CMat applyStep(const dd::CMat& mat, const OracleStep& step) {
+  auto res = dd::CMat(mat.size(), dd::CVec(mat.size(), 0.));
+  for (std::size_t i = 0U; i < mat.size(); ++i) {
+    const auto row = mapIndex(i, step);
+    for (std::size_t j = 0U; j < mat.size(); ++j) {
+      res[row][mapIndex(j, step)] = mat[i][j];
+    }
+  }
+  return res;
+}
+
+void expectMatrixNear(const dd::CMat& actual, const dd::CMat& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0U; i < actual.size(); ++i) {
+    for (std::size_t j = 0U; j < actual.size(); ++j) {
+      EXPECT_NEAR(actual[i][j].real(), expected[i][j].real(), 1e-10)
+          << "mismatch at (" << i << ", " << j << ")";
+      EXPECT_NEAR(actual[i][j].imag(), expected[i][j].imag(), 1e-10)
+          << "mismatch at (" << i << ", " << j << ")";
+    }
+  }
+}
+
+/// Compare the multisets of entries of two matrices. Real parts, imaginary
+/// parts and magnitudes are compared separately since one-dimensional sorting
+/// is robust against rounding noise.
+void expectSameEntries(const dd::CMat& actual, const dd::CMat& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  const auto flatten = [](const dd::CMat& mat, auto proj) {
+    std::vector<dd::fp> values;
+    for (const auto& row : mat) {
+      for (const auto& entry : row) {
+        values.emplace_back(proj(entry));
+      }
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+  };
+  const auto re = [](const std::complex<dd::fp>& c) { return c.real(); };
+  const auto im = [](const std::complex<dd::fp>& c) { return c.imag(); };
+  const auto mag = [](const std::complex<dd::fp>& c) { return std::abs(c); };
+  for (const auto& [a, b] :
+       {std::pair{flatten(actual, re), flatten(expected, re)},
+        std::pair{flatten(actual, im), flatten(expected, im)},
+        std::pair{flatten(actual, mag), flatten(expected, mag)}}) {
+    for (std::size_t k = 0U; k < a.size(); ++k) {
+      EXPECT_NEAR(a[k], b[k], 1e-10);
+    }
+  }
+}
+
+/// Every non-terminal successor of a node at level v has to be at level v-1
+/// and terminal successors of non-bottom nodes have to be zero.
+bool isLevelComplete(const qc::MatrixDD& root) {
+  std::queue<const dd::mNode*> que;
+  std::unordered_set<const dd::mNode*> visited;
+  if (root.isTerminal()) {
+    return true;
+  }
+  que.push(root.p);
+  visited.emplace(root.p);
+  while (!que.empty()) {
+    const auto* node = que.front();
+    que.pop();
+    for (const auto& e : node->e) {
+      if (e.isTerminal()) {
+        if (node->v != 0 && !e.w.exactlyZero()) {
+          return false;
+        }
+        continue;
+      }
+      if (e.p->v + 1 != node->v) {
+        return false;
+      }
+      if (visited.emplace(e.p).second) {
+        que.push(e.p);
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+class DDReorder : public testing::TestWithParam<std::size_t> {
+protected:
+  void SetUp() override {
+    mt.seed(GetParam());
+    qc = std::make_unique<qc::QuantumComputation>(nqubits);
+    buildRandomCircuit();
+    dd = std::make_unique<dd::Package<>>(nqubits);
+    func = dd::buildFunctionality(qc.get(), *dd);
+    original = func.getMatrix(nqubits);
+  }
+
+  /// Random circuit that leaves some qubits idle for a while, so that the
+  /// resulting DD contains skipped nodes that have to be completed first.
+  void buildRandomCircuit() {
+    auto qubitDist = std::uniform_int_distribution<qc::Qubit>(
+        0U, static_cast<qc::Qubit>(nqubits - 1U));
+    auto gateDist = std::uniform_int_distribution<int>(0, 5);
+    auto angleDist = std::uniform_real_distribution<dd::fp>(0., 2. * dd::PI);
+    for (std::size_t g = 0U; g < ngates; ++g) {
+      const auto target = qubitDist(mt);
+      auto control = qubitDist(mt);
+      while (control == target) {
+        control = qubitDist(mt);
+      }
+      switch (gateDist(mt)) {
+      case 0:
+        qc->h(target);
+        break;
+      case 1:
+        qc->t(target);
+        break;
+      case 2:
+        qc->rz(angleDist(mt), target);
+        break;
+      case 3:
+        qc->ry(angleDist(mt), target);
+        break;
+      case 4:
+        qc->cx(control, target);
+        break;
+      default:
+        qc->cz(control, target);
+        break;
+      }
+    }
+    // make sure the root node resides at the top level
+    qc->h(static_cast<qc::Qubit>(nqubits - 1U));
+  }
+
+  /// Draw a random step and report it both as oracle step and in the
+  /// (`level`, `up`) encoding used by `levelExchange` and `linearExchange`.
+  OracleStep randomStep(dd::Qubit& level, bool& up) {
+    static constexpr std::array SCHEMES{dd::SCHEME_SIFTING,
+                                        dd::SCHEME_LTRANS_UPPER,
+                                        dd::SCHEME_LTRANS_LOWER};
+    auto levelDist = std::uniform_int_distribution<dd::Qubit>(
+        1U, static_cast<dd::Qubit>(nqubits - 1U));
+    auto schemeDist = std::uniform_int_distribution<std::size_t>(0U, 2U);
+    auto upDist = std::bernoulli_distribution(0.5);
+    const auto step = OracleStep{levelDist(mt), SCHEMES.at(schemeDist(mt))};
+    up = upDist(mt);
+    level = up ? step.level - 1U : step.level;
+    return step;
+  }
+
+  /// Apply random steps to a completed DD, compare every intermediate result
+  /// against the oracle and finally undo everything through resetVorder.
+  template <class Config>
+  void checkRandomStepsMatchOracle(dd::Package<Config>& pkg, qc::MatrixDD f) {
+    dd::levelCompleteSkipped(f, &pkg);
+    const auto initialSize = f.size();
+    const auto initialPermutation = qc->outputPermutation;
+
+    auto vo = dd::VarOrder(f, qc.get());
+    auto expected = original;
+    for (std::size_t s = 0U; s < nsteps; ++s) {
+      dd::Qubit level{};
+      bool up{};
+      const auto step = randomStep(level, up);
+      if (step.scheme == dd::SCHEME_SIFTING) {
+        dd::levelExchange(level, &pkg, qc.get(), up);
+      } else {
+        dd::linearExchange(level, &pkg, qc.get(), step.scheme, up);
+      }
+      vo.record(level, step.scheme, f.size(), up);
+      expected = applyStep(expected, step);
+
+      ASSERT_TRUE(isLevelComplete(f));
+      expectMatrixNear(f.getMatrix(nqubits), expected);
+    }
+
+    dd::resetVorder(&pkg, qc.get(), &vo, true);
+    EXPECT_TRUE(vo.isRecordEmpty());
+    expectMatrixNear(f.getMatrix(nqubits), original);
+    EXPECT_EQ(f.size(), initialSize);
+    EXPECT_EQ(qc->outputPermutation, initialPermutation);
+  }
+
+  /// The linear transformation passes keep their steps internal, so only
+  /// check that the result is an index relabeling of the original matrix.
+  void checkReorderPermutesEntries(const dd::ReorderScheme scheme) {
+    dd::levelCompleteSkipped(func, dd.get());
+    const auto initialSize = func.size();
+    dd::reorderSelect(func, dd.get(), qc.get(), scheme);
+    ASSERT_TRUE(isLevelComplete(func));
+    EXPECT_LE(func.size(), initialSize);
+    expectSameEntries(func.getMatrix(nqubits), original);
+  }
+
+  std::size_t nqubits = 5U;
+  std::size_t ngates = 30U;
+  std::size_t nsteps = 40U;
+  std::mt19937_64 mt;
+  std::unique_ptr<qc::QuantumComputation> qc;
+  std::unique_ptr<dd::Package<>> dd;
+  qc::MatrixDD func{};
+  dd::CMat original;
+};
+
+INSTANTIATE_TEST_SUITE_P(Seeds, DDReorder,
+                         testing::Range<std::size_t>(0U, 16U));
+
+TEST_P(DDReorder, LevelCompleteSkippedPreservesMatrix) {
+  dd::levelCompleteSkipped(func, dd.get());
+  EXPECT_TRUE(isLevelComplete(func));
+  expectMatrixNear(func.getMatrix(nqubits), original);
+}
+
+TEST_P(DDReorder, RandomStepsMatchOracle) {
+  checkRandomStepsMatchOracle(*dd, func);
+}
+
+TEST_P(DDReorder, RandomStepsMatchOracleOpenAddressing) {
+  auto bucketed =
+      std::make_unique<dd::Package<dd::OpenAddressingDDPackageConfig>>(
+          nqubits);
+  checkRandomStepsMatchOracle(*bucketed,
+                              dd::buildFunctionality(qc.get(), *bucketed));
+}
+
+TEST_P(DDReorder, ResetWithoutPopKeepsRecords) {
+  dd::levelCompleteSkipped(func, dd.get());
+  auto vo = dd::VarOrder(func, qc.get());
+  for (std::size_t s = 0U; s < nsteps; ++s) {
+    dd::Qubit level{};
+    bool up{};
+    const auto step = randomStep(level, up);
+    dd::linearExchange(level, dd.get(), qc.get(), step.scheme, up);
+    vo.record(level, step.scheme, func.size(), up);
+  }
+
+  dd::resetVorder(dd.get(), qc.get(), &vo, false);
+  EXPECT_EQ(static_cast<std::size_t>(vo.size()), nsteps);
+  expectMatrixNear(func.getMatrix(nqubits), original);
+}
+
+TEST_P(DDReorder, SiftingIsUndoneByReset) {
+  dd::levelCompleteSkipped(func, dd.get());
+  const auto initialPermutation = qc->outputPermutation;
+  auto vo = dd::VarOrder(func, qc.get());
+  dd::reorderSelect(func, dd.get(), qc.get(), dd::SCHEME_SIFTING, &vo);
+  ASSERT_TRUE(isLevelComplete(func));
+
+  dd::resetVorder(dd.get(), qc.get(), &vo, true);
+  expectMatrixNear(func.getMatrix(nqubits), original);
+  EXPECT_EQ(qc->outputPermutation, initialPermutation);
+}
+
+TEST_P(DDReorder, LinearTransUpperPermutesEntries) {
+  checkReorderPermutesEntries(dd::SCHEME_LTRANS_UPPER);
+}
+
+TEST_P(DDReorder, LinearTransLowerPermutesEntries) {
+  checkReorderPermutesEntries(dd::SCHEME_LTRANS_LOWER);
+}
+
+TEST_P(DDReorder, LinearTransMixedPermutesEntries) {
+  checkReorderPermutesEntries(dd::SCHEME_LTRANS_MIXED);
+}
@@ -213,6 +213,25 @@ TEST(MatrixFunctionality, GetMatrixRoundtrip) {
   }
 }
 
+TEST(MatrixFunctionality, GetMatrixSkippedLevels) {
+  auto dd = std::make_unique<dd::Package<>>(3);
+  // Z (x) H (x) I, where the identity is skipped below edges with weight -1
+  const auto matDD = dd->multiply(dd->makeGateDD(dd::Z_MAT, 2),
+                                  dd->makeGateDD(dd::H_MAT, 1));
+  const auto matVec = matDD.getMatrix(dd->qubits());
+  for (std::size_t i = 0U; i < matVec.size(); ++i) {
+    for (std::size_t j = 0U; j < matVec.size(); ++j) {
+      const auto z = ((i >> 2U) & 1U) == 1U ? -1. : 1.;
+      const auto h = ((i >> 1U) & (j >> 1U) & 1U) == 1U ? -SQRT2_2 : SQRT2_2;
+      const auto ref = ((i ^ j) & 5U) == 0U ? z * h : 0.;
+      EXPECT_NEAR(matVec[i][j].real(), ref, 1e-10);
+      EXPECT_NEAR(matVec[i][j].imag(), 0., 1e-10);
+      const auto val = matDD.getValueByIndex(dd->qubits(), i, j);
+      EXPECT_NEAR(val.real(), ref, 1e-10);
+    }
+  }
+}
+
 TEST(MatrixFunctionality, GetMatrixTolerance) {
   auto dd = std::make_unique<dd::Package<>>(2);
   // clang-format off
@@ -1,19 +1,27 @@
 #include "Definitions.hpp"
+#include "dd/ColumnarSerialization.hpp"
+#include "dd/CompactDD.hpp"
+#include "dd/ComputeTable.hpp"
 #include "dd/DDDefinitions.hpp"
 #include "dd/DDpackageConfig.hpp"
+#include "dd/DenseExport.hpp"
 #include "dd/Export.hpp"
 #include "dd/GateMatrixDefinitions.hpp"
 #include "dd/MemoryManager.hpp"
 #include "dd/Node.hpp"
 #include "dd/Package.hpp"
 #include "dd/RealNumber.hpp"
+#include "dd/Sampler.hpp"
+#include "dd/UniqueTable.hpp"
 #include "dd/statistics/PackageStatistics.hpp"
 #include "ir/operations/Control.hpp"
 
 #include <array>
 #include <cmath>
+#include <complex>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
@@ -21,10 +29,13 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <nlohmann/json.hpp>
 #include <random>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -272,6 +283,111 @@ TEST(DDPackageTest, CorruptedBellState) {
                std::runtime_error);
 }
 
+TEST(DDPackageTest, SampleFromState) {
+  auto dd = std::make_unique<dd::Package<>>(3);
+  // probabilities 0.1 (|001>), 0.2 (|010>), 0.3 (|101>), 0.4 (|111>)
+  const dd::CVec vec{0., std::sqrt(0.1), std::sqrt(0.2), 0.,
+                     0., std::sqrt(0.3), 0.,             std::sqrt(0.4)};
+  auto state = dd->makeStateFromVector(vec);
+  // sampling does not require a normalized state
+  state.w = dd->cn.lookup(0.5, 0);
+
+  const dd::Sampler sampler(state);
+  EXPECT_EQ(sampler.numQubits(), 3U);
+  EXPECT_EQ(sampler.toBitString(5U), "101");
+
+  constexpr std::size_t shots = 100000U;
+  const auto histogram = sampler.sample(shots, 42U);
+  std::size_t total = 0U;
+  for (const auto& [outcome, count] : histogram) {
+    total += count;
+    EXPECT_NEAR(static_cast<double>(count) / shots, std::norm(vec[outcome]),
+                0.01);
+  }
+  EXPECT_EQ(total, shots);
+  EXPECT_EQ(histogram.size(), 4U);
+
+  // shots only depend on the seed and their index
+  EXPECT_EQ(sampler.sample(shots, 42U, 4U), histogram);
+  EXPECT_EQ(sampler.sample(shots, 42U, 0U), histogram);
+  EXPECT_EQ(sampler.sampleShot(17U, 7U), sampler.sampleShot(17U, 7U));
+  EXPECT_EQ(histogram.count(sampler.sampleShot(42U, 3U)), 1U);
+  EXPECT_TRUE(sampler.sample(0U, 42U).empty());
+
+  state.w = dd::Complex::zero();
+  EXPECT_THROW(dd::Sampler{state}, std::runtime_error);
+}
+
+TEST(DDPackageTest, DenseExport) {
+  constexpr std::size_t nqubits = 6U;
+  constexpr std::size_t dim = 1U << nqubits;
+  auto dd = std::make_unique<dd::Package<>>(nqubits);
+
+  // a random state with zero blocks and an upper half that is a multiple of
+  // the lower half (i.e., a shared node)
+  std::mt19937_64 mt(42U);
+  std::normal_distribution<dd::fp> dist(0., 1.);
+  dd::CVec vec(dim);
+  for (std::size_t i = 0U; i < dim / 2U; ++i) {
+    vec[i] = (i / 4U) % 3U == 1U ? 0. : std::complex{dist(mt), dist(mt)};
+    vec[i + (dim / 2U)] = std::complex{0.5, -0.5} * vec[i];
+  }
+  const auto state = dd->makeStateFromVector(vec);
+  const auto expectedVector = state.getVector();
+  for (const std::size_t threads : {1U, 3U, 0U}) {
+    const auto buffer = dd::getDenseVector(state, nqubits, threads);
+    ASSERT_EQ(buffer.size(), dim);
+    EXPECT_FALSE(buffer.mapped());
+    for (std::size_t i = 0U; i < dim; ++i) {
+      EXPECT_NEAR(std::abs(buffer[i] - expectedVector[i]), 0., 1e-12);
+    }
+  }
+
+  // a matrix with skipped identity levels
+  auto matrix = dd->makeGateDD(dd::H_MAT, 3);
+  matrix = dd->multiply(dd->makeGateDD(dd::X_MAT, 1_pc, 4), matrix);
+  matrix = dd->multiply(dd->makeGateDD(dd::rzMat(0.3), 0_nc, 5), matrix);
+  matrix = dd->multiply(dd->makeGateDD(dd::ryMat(0.7), 2), matrix);
+  const auto expectedMatrix = matrix.getMatrix(nqubits);
+  for (const std::size_t threads : {1U, 4U}) {
+    const auto buffer = dd::getDenseMatrix(matrix, nqubits, threads);
+    ASSERT_EQ(buffer.size(), dim * dim);
+    for (std::size_t i = 0U; i < dim; ++i) {
+      for (std::size_t j = 0U; j < dim; ++j) {
+        EXPECT_NEAR(std::abs(buffer[(i * dim) + j] - expectedMatrix[i][j]), 0.,
+                    1e-12);
+      }
+    }
+  }
+
+  // a memory-mapped buffer leaves the export in the file
+  const auto file =
+      std::filesystem::temp_directory_path() / "mqt_core_dense_export.bin";
+  {
+    const auto buffer =
+        dd::getDenseVector(state, nqubits, 2U, file.string());
+    EXPECT_TRUE(buffer.mapped());
+    for (std::size_t i = 0U; i < dim; ++i) {
+      EXPECT_NEAR(std::abs(buffer[i] - expectedVector[i]), 0., 1e-12);
+    }
+  }
+  std::vector<std::complex<dd::fp>> fromFile(dim);
+  std::ifstream ifs(file, std::ios::binary);
+  ifs.read(reinterpret_cast<char*>(fromFile.data()),
+           static_cast<std::streamsize>(dim * sizeof(std::complex<dd::fp>)));
+  EXPECT_TRUE(ifs.good());
+  ifs.close();
+  std::filesystem::remove(file);
+  for (std::size_t i = 0U; i < dim; ++i) {
+    EXPECT_NEAR(std::abs(fromFile[i] - expectedVector[i]), 0., 1e-12);
+  }
+
+  EXPECT_THROW(std::ignore = dd::getDenseVector(state, nqubits + 1U),
+               std::invalid_argument);
+  EXPECT_THROW(std::ignore = dd::getDenseMatrix(matrix, 5U),
+               std::invalid_argument);
+}
+
 TEST(DDPackageTest, NegativeControl) {
   auto dd = std::make_unique<dd::Package<>>(2);
 
@@ -615,6 +731,200 @@ TEST(DDPackageTest, SerializationErrors) {
   EXPECT_THROW(dd->deserialize<dd::mNode>(ss), std::runtime_error);
 }
 
+TEST(DDPackageTest, ColumnarSerialization) {
+  auto dd = std::make_unique<dd::Package<>>(4);
+  auto state = dd->makeZeroState(4);
+  for (dd::Qubit q = 0; q < 4; ++q) {
+    state = dd->multiply(dd->makeGateDD(dd::H_MAT, q), state);
+  }
+  state = dd->multiply(dd->makeGateDD(dd::T_MAT, 2), state);
+  state = dd->multiply(dd->makeGateDD(dd::X_MAT, 3_pc, 0), state);
+  state = dd->multiply(dd->makeGateDD(dd::S_MAT, 1), state);
+  dd->incRef(state);
+  // a skipped identity level and a terminal below the top level
+  auto matrix = dd->multiply(dd->makeGateDD(dd::X_MAT, 2_pc, 1),
+                             dd->makeGateDD(dd::H_MAT, 2));
+  dd->incRef(matrix);
+
+  // loading into the same package yields the same nodes
+  serializeColumnar(state, "state_columnar.dd");
+  EXPECT_EQ(dd::deserializeColumnar<dd::vNode>("state_columnar.dd", *dd),
+            state);
+  std::filesystem::remove("state_columnar.dd");
+  std::stringstream ss{};
+  serializeColumnar(matrix, ss);
+  const auto data = ss.str();
+  // the parser requires 8-byte aligned data
+  std::vector<std::uint64_t> buffer((data.size() + 7U) / 8U);
+  std::memcpy(buffer.data(), data.data(), data.size());
+  const auto* begin = reinterpret_cast<const char*>(buffer.data());
+  EXPECT_EQ(dd::deserializeColumnar<dd::mNode>(begin, data.size(), *dd),
+            matrix);
+
+  const auto view = dd::parseColumnar(begin, data.size());
+  EXPECT_EQ(view.radix, dd::NEDGE);
+  EXPECT_EQ(view.numNodes, matrix.size() - 1U);
+  for (std::size_t i = 1U; i < view.numNodes; ++i) {
+    EXPECT_LE(view.levels[i - 1U], view.levels[i]);
+  }
+  for (std::size_t i = 0U; i < view.numWeights; ++i) {
+    for (std::size_t j = 0U; j < i; ++j) {
+      EXPECT_FALSE(view.weights[2U * i] == view.weights[2U * j] &&
+                   view.weights[(2U * i) + 1U] == view.weights[(2U * j) + 1U]);
+    }
+  }
+
+  // and into a different package the same functions
+  auto other = std::make_unique<dd::Package<>>(4);
+  serializeColumnar(state, "state_columnar.dd");
+  const auto loaded =
+      dd::deserializeColumnar<dd::vNode>("state_columnar.dd", *other);
+  std::filesystem::remove("state_columnar.dd");
+  EXPECT_EQ(loaded.size(), state.size());
+  const auto expected = state.getVector();
+  const auto actual = loaded.getVector();
+  for (std::size_t i = 0U; i < expected.size(); ++i) {
+    EXPECT_NEAR(std::abs(actual[i] - expected[i]), 0., 1e-12);
+  }
+  const auto loadedMatrix =
+      dd::deserializeColumnar<dd::mNode>(begin, data.size(), *other);
+  EXPECT_EQ(loadedMatrix.getMatrix(4), matrix.getMatrix(4));
+
+  // terminal DDs
+  ss.str("");
+  serializeColumnar(dd::vEdge::one(), ss);
+  const auto terminal = ss.str();
+  buffer.assign((terminal.size() + 7U) / 8U, 0U);
+  std::memcpy(buffer.data(), terminal.data(), terminal.size());
+  EXPECT_EQ(dd::deserializeColumnar<dd::vNode>(begin, terminal.size(), *dd),
+            dd::vEdge::one());
+}
+
+TEST(DDPackageTest, ColumnarSerializationErrors) {
+  auto dd = std::make_unique<dd::Package<>>(2);
+  auto bellState =
+      dd->multiply(dd->multiply(dd->makeGateDD(dd::X_MAT, 1_pc, 0),
+                                dd->makeGateDD(dd::H_MAT, 1)),
+                   dd->makeZeroState(2));
+
+  EXPECT_THROW(
+      serializeColumnar(bellState, "./path/that/does/not/exist/filename.dd"),
+      std::invalid_argument);
+  EXPECT_THROW(dd::deserializeColumnar<dd::vNode>(
+                   "./path/that/does/not/exist/filename.dd", *dd),
+               std::invalid_argument);
+
+  std::stringstream ss{};
+  serializeColumnar(bellState, ss);
+  const auto data = ss.str();
+  std::vector<std::uint64_t> buffer((data.size() + 8U) / 8U);
+  auto* begin = reinterpret_cast<char*>(buffer.data());
+  const auto load = [&](const std::size_t size) {
+    return dd::deserializeColumnar<dd::vNode>(begin, size, *dd);
+  };
+  const auto reset = [&]() {
+    std::memcpy(begin, data.data(), data.size());
+  };
+
+  // unaligned data
+  reset();
+  EXPECT_THROW(dd::parseColumnar(begin + 1, data.size() - 1U),
+               std::runtime_error);
+  // wrong kind of DD
+  EXPECT_THROW(dd::deserializeColumnar<dd::mNode>(begin, data.size(), *dd),
+               std::runtime_error);
+  // truncated data
+  EXPECT_THROW(load(16U), std::runtime_error);
+  EXPECT_THROW(load(data.size() - 8U), std::runtime_error);
+  // wrong magic
+  begin[0] = 'X';
+  EXPECT_THROW(load(data.size()), std::runtime_error);
+  // wrong version (right after the 8-byte magic)
+  reset();
+  begin[8] = 2;
+  EXPECT_THROW(load(data.size()), std::runtime_error);
+  // a root index out of range (the second to last field of the header)
+  reset();
+  std::memset(begin + 32, 0x7f, 4U);
+  EXPECT_THROW(load(data.size()), std::runtime_error);
+  // a weight index out of range (the last field of the header)
+  reset();
+  std::memset(begin + 36, 0x7f, 4U);
+  EXPECT_THROW(load(data.size()), std::runtime_error);
+
+  reset();
+  EXPECT_EQ(load(data.size()), bellState);
+}
+
+TEST(DDPackageTest, ImportBetweenPackages) {
+  auto src = std::make_unique<dd::Package<>>(3);
+  auto state = src->makeZeroState(3);
+  auto matrix = src->makeIdent();
+  for (dd::Qubit q = 0; q < 3; ++q) {
+    matrix = src->multiply(src->makeGateDD(dd::H_MAT, q), matrix);
+  }
+  matrix = src->multiply(src->makeGateDD(dd::T_MAT, 1_pc, 2), matrix);
+  matrix = src->multiply(src->makeGateDD(dd::S_MAT, 0), matrix);
+  state = src->multiply(matrix, state);
+  src->incRef(state);
+  src->incRef(matrix);
+
+  // the destination grows to the size of the source
+  auto dst = std::make_unique<dd::Package<>>(1);
+  const auto importedState = dst->import(*src, state);
+  EXPECT_EQ(dst->qubits(), 3U);
+  EXPECT_EQ(importedState.size(), state.size());
+  const auto expected = state.getVector();
+  const auto actual = importedState.getVector();
+  for (std::size_t i = 0U; i < expected.size(); ++i) {
+    EXPECT_NEAR(std::abs(actual[i] - expected[i]), 0., 1e-12);
+  }
+  // nodes are shared with DDs that already exist in the destination
+  EXPECT_EQ(dst->import(*src, state), importedState);
+
+  const auto importedMatrix = dst->import(*src, matrix);
+  EXPECT_EQ(importedMatrix.size(), matrix.size());
+  EXPECT_EQ(importedMatrix.getMatrix(3), matrix.getMatrix(3));
+  EXPECT_EQ(dst->import(*src, dd::mEdge::one()), dd::mEdge::one());
+
+  // density matrices keep their temporary flags
+  using DensityPackage =
+      dd::Package<dd::DensityMatrixSimulatorDDPackageConfig>;
+  auto densitySrc = std::make_unique<DensityPackage>(3);
+  auto rho = densitySrc->makeZeroDensityOperator(3);
+  densitySrc->incRef(rho);
+  densitySrc->applyOperationToDensity(rho,
+                                      densitySrc->makeGateDD(dd::H_MAT, 0));
+  densitySrc->applyOperationToDensity(
+      rho, densitySrc->makeGateDD(dd::X_MAT, 0_pc, 2));
+  densitySrc->applyOperationToDensity(rho,
+                                      densitySrc->makeGateDD(dd::T_MAT, 1));
+  auto densityDst = std::make_unique<DensityPackage>(3);
+  auto imported = densityDst->import(*densitySrc, rho);
+  EXPECT_EQ(dd::dNode::getDensityMatrixTempFlags(imported.p),
+            dd::dNode::getDensityMatrixTempFlags(rho.p));
+  EXPECT_EQ(imported.getMatrix(3), rho.getMatrix(3));
+  EXPECT_EQ(imported.getSparseProbabilityVector(3, 0.),
+            rho.getSparseProbabilityVector(3, 0.));
+
+  // the imported DD can be used in further operations
+  auto aligned = imported;
+  dd::dEdge::alignDensityEdge(aligned);
+  densityDst->incRef(aligned);
+  densitySrc->applyOperationToDensity(rho,
+                                      densitySrc->makeGateDD(dd::H_MAT, 2));
+  densityDst->applyOperationToDensity(imported,
+                                      densityDst->makeGateDD(dd::H_MAT, 2));
+  const auto rhoMatrix = rho.getMatrix(3);
+  const auto importedMatrixAfter = imported.getMatrix(3);
+  for (std::size_t i = 0U; i < rhoMatrix.size(); ++i) {
+    for (std::size_t j = 0U; j < rhoMatrix.size(); ++j) {
+      EXPECT_NEAR(std::abs(importedMatrixAfter[i][j] - rhoMatrix[i][j]), 0.,
+                  1e-12);
+    }
+  }
+}
+
 TEST(DDPackageTest, Ancillaries) {
   auto dd = std::make_unique<dd::Package<>>(4);
   auto hGate = dd->makeGateDD(dd::H_MAT, 0);
@@ -981,6 +1291,520 @@ TEST(DDPackageTest, UniqueTableAllocation) {
   EXPECT_EQ(dd->vMemoryManager.getStats().numAllocated, allocs);
 }
 
+TEST(DDPackageTest, MemoryManagerReleasesEmptyChunks) {
+  for (const auto useArena : {false, true}) {
+    dd::MemoryManager<dd::vNode> mm{16U, useArena};
+    EXPECT_EQ(mm.usesArena(), useArena);
+    const auto initial = mm.getStats().numAllocated;
+    EXPECT_GE(initial, 16U);
+    EXPECT_GE(mm.getStats().numReservedBytes, initial * sizeof(dd::vNode));
+
+    // fill the first chunk and the complete second chunk
+    std::vector<dd::vNode*> first{};
+    std::vector<dd::vNode*> rest{};
+    for (std::size_t i = 0U; i < initial; ++i) {
+      first.emplace_back(mm.get());
+    }
+    while (mm.getStats().numAllocations < 3U || rest.empty()) {
+      rest.emplace_back(mm.get());
+    }
+    const auto allocated = mm.getStats().numAllocated;
+    EXPECT_EQ(mm.getStats().numAllocations, 3U);
+    // nothing can be released while entries are in use
+    for (auto* n : first) {
+      n->v = 1;
+    }
+    EXPECT_EQ(mm.releaseEmptyChunks(), 0U);
+
+    // returning the first chunk allows releasing it, but not the current one
+    for (auto* n : first) {
+      mm.returnEntry(n);
+    }
+    EXPECT_EQ(mm.releaseEmptyChunks(), 1U);
+    EXPECT_EQ(mm.getStats().numReleasedChunks, 1U);
+    EXPECT_EQ(mm.getStats().numAllocated, allocated - initial);
+    EXPECT_EQ(mm.getStats().numAvailableForReuse, 0U);
+    EXPECT_EQ(mm.getStats().numUsed, rest.size());
+
+    // the manager remains fully usable
+    auto* n = mm.get();
+    ASSERT_NE(n, nullptr);
+    EXPECT_EQ(n->ref, 0U);
+    EXPECT_EQ(n->v, 0);
+    mm.reset();
+    EXPECT_EQ(mm.getStats().numUsed, 0U);
+    EXPECT_EQ(mm.getStats().numReleasedChunks, 1U);
+    // the oldest remaining chunk (the second one) is kept
+    EXPECT_EQ(mm.getStats().numAllocated, 2U * initial);
+  }
+}
+
+namespace {
+struct SmallBucketedTableConfig : public dd::DDPackageConfig {
+  static constexpr bool UT_OPEN_ADDRESSING = true;
+  static constexpr std::size_t UT_VEC_NBUCKET = 64U;
+  static constexpr std::size_t UT_MAT_NBUCKET = 64U;
+};
+} // namespace
+
+TEST(DDPackageTest, BucketedUniqueTableGrowAndCollect) {
+  constexpr std::size_t nq = 8U;
+  auto dd = std::make_unique<dd::Package<SmallBucketedTableConfig>>(nq);
+  const auto initialBuckets = dd->vUniqueTable.getStats(0).numBuckets;
+
+  std::vector<dd::vEdge> states;
+  for (std::size_t i = 0U; i < (1ULL << nq); ++i) {
+    std::vector<bool> bits(nq);
+    for (std::size_t q = 0U; q < nq; ++q) {
+      bits[q] = ((i >> q) & 1U) != 0U;
+    }
+    auto state = dd->makeBasisState(nq, bits);
+    dd->incRef(state);
+    states.emplace_back(state);
+  }
+  // the top-most variable holds one node per basis state prefix
+  EXPECT_EQ(dd->vUniqueTable.getStats(nq - 1U).numEntries, 1ULL << nq);
+  EXPECT_GT(dd->vUniqueTable.getStats(nq - 1U).numBuckets, initialBuckets);
+
+  // looking up the states again must return the very same nodes
+  for (std::size_t i = 0U; i < states.size(); ++i) {
+    std::vector<bool> bits(nq);
+    for (std::size_t q = 0U; q < nq; ++q) {
+      bits[q] = ((i >> q) & 1U) != 0U;
+    }
+    EXPECT_EQ(dd->makeBasisState(nq, bits).p, states[i].p);
+    EXPECT_EQ(states[i].getValueByIndex(i), std::complex<dd::fp>{1.});
+  }
+
+  // release half of the states and collect them
+  for (std::size_t i = 0U; i < states.size(); i += 2U) {
+    dd->decRef(states[i]);
+  }
+  dd->garbageCollect(true);
+  EXPECT_EQ(dd->vUniqueTable.getStats(nq - 1U).numEntries, 1ULL << (nq - 1U));
+  for (std::size_t i = 1U; i < states.size(); i += 2U) {
+    EXPECT_EQ(states[i].getValueByIndex(i), std::complex<dd::fp>{1.});
+  }
+
+  for (std::size_t i = 1U; i < states.size(); i += 2U) {
+    dd->decRef(states[i]);
+  }
+  dd->garbageCollect(true);
+  EXPECT_EQ(dd->vUniqueTable.getNumEntries(), 0U);
+}
+
+TEST(DDPackageTest, BucketedUniqueTableMatchesChained) {
+  constexpr std::size_t nq = 4U;
+  auto chained = std::make_unique<dd::Package<>>(nq);
+  auto bucketed = std::make_unique<dd::Package<SmallBucketedTableConfig>>(nq);
+
+  const auto build = [](auto& pkg) {
+    auto e = pkg.makeIdent();
+    for (std::size_t q = 0U; q < nq; ++q) {
+      e = pkg.multiply(pkg.makeGateDD(dd::H_MAT, static_cast<dd::Qubit>(q)), e);
+      e = pkg.multiply(
+          pkg.makeGateDD(dd::X_MAT, qc::Controls{static_cast<dd::Qubit>(q)},
+                         static_cast<dd::Qubit>((q + 1U) % nq)),
+          e);
+      e = pkg.multiply(pkg.makeGateDD(dd::T_MAT, static_cast<dd::Qubit>(q)), e);
+    }
+    return e;
+  };
+  const auto a = build(*chained);
+  const auto b = build(*bucketed);
+  EXPECT_EQ(a.size(), b.size());
+  EXPECT_EQ(a.getMatrix(nq), b.getMatrix(nq));
+  EXPECT_EQ(chained->mUniqueTable.getNumEntries(),
+            bucketed->mUniqueTable.getNumEntries());
+}
+
+TEST(DDPackageTest, SetAssociativeComputeTableKeepsCollidingEntries) {
+  // a single set, i.e., all keys collide
+  dd::ComputeTable<int, int, int, 4U, 4U> ct{};
+  for (int i = 0; i < 4; ++i) {
+    ct.insert(i, i, 10 * i);
+  }
+  for (int i = 0; i < 4; ++i) {
+    const auto* r = ct.lookup(i, i);
+    ASSERT_NE(r, nullptr);
+    EXPECT_EQ(*r, 10 * i);
+  }
+  EXPECT_EQ(ct.getStats().collisions, 0U);
+  EXPECT_EQ(ct.getStats().numEntries, 4U);
+
+  // re-inserting the same operands updates the entry in place
+  ct.insert(2, 2, 42);
+  EXPECT_EQ(*ct.lookup(2, 2), 42);
+  EXPECT_EQ(ct.getStats().collisions, 0U);
+
+  // the least recently used entry (0) is evicted first
+  ct.insert(4, 4, 40);
+  EXPECT_EQ(ct.getStats().collisions, 1U);
+  EXPECT_EQ(ct.lookup(0, 0), nullptr);
+  for (int i = 1; i <= 4; ++i) {
+    EXPECT_NE(ct.lookup(i, i), nullptr);
+  }
+
+  // touching entry 1 protects it, so 3 is the next victim
+  ct.lookup(1, 1);
+  ct.lookup(2, 2);
+  ct.lookup(4, 4);
+  ct.insert(5, 5, 50);
+  EXPECT_EQ(ct.lookup(3, 3), nullptr);
+  EXPECT_NE(ct.lookup(1, 1), nullptr);
+  EXPECT_NE(ct.lookup(5, 5), nullptr);
+
+  ct.clear();
+  EXPECT_EQ(ct.lookup(1, 1), nullptr);
+  EXPECT_EQ(ct.getStats().numEntries, 0U);
+}
+
+TEST(DDPackageTest, SetAssociativeComputeTableKeepsDensityAndMatrixResults) {
+  // a single set holding both kinds of results for the same operands
+  dd::ComputeTable<dd::dNode*, dd::dNode*, dd::dCachedEdge, 2U, 2U> ct{};
+  dd::dNode left{};
+  dd::dNode right{};
+  dd::dNode matrix{};
+  dd::dNode density{};
+  density.flags = 8U;
+  ct.insert(&left, &right, {&density, dd::ComplexValue{1.}});
+  ct.insert(&left, &right, {&matrix, dd::ComplexValue{1.}});
+  EXPECT_EQ(ct.getStats().numEntries, 2U);
+
+  // the most recently used entry does not hide the other kind
+  const auto* r = ct.lookup(&left, &right, true);
+  ASSERT_NE(r, nullptr);
+  EXPECT_EQ(r->p, &density);
+  r = ct.lookup(&left, &right, false);
+  ASSERT_NE(r, nullptr);
+  EXPECT_EQ(r->p, &matrix);
+
+  // re-inserting a kind only updates the entry of that kind
+  dd::dNode density2{};
+  density2.flags = 8U;
+  ct.insert(&left, &right, {&density2, dd::ComplexValue{1.}});
+  EXPECT_EQ(ct.getStats().collisions, 0U);
+  EXPECT_EQ(ct.lookup(&left, &right, true)->p, &density2);
+  EXPECT_EQ(ct.lookup(&left, &right, false)->p, &matrix);
+}
+
+TEST(DDPackageTest, ComputeTableHitRatioDelta) {
+  dd::ComputeTable<int, int, int, 16U, 2U> ct{};
+  ct.insert(1, 1, 1);
+  // 1 hit out of 2 lookups before the checkpoint
+  ct.lookup(1, 1);
+  ct.lookup(2, 2);
+  EXPECT_DOUBLE_EQ(ct.getStats().hitRatio(), 0.5);
+  ct.checkpointStatistics();
+  EXPECT_DOUBLE_EQ(ct.getStats().hitRatioSinceCheckpoint(), 1.);
+  EXPECT_DOUBLE_EQ(ct.getStats().hitRatioDelta(), 0.);
+
+  // 3 hits out of 4 lookups after the checkpoint
+  ct.lookup(1, 1);
+  ct.lookup(1, 1);
+  ct.lookup(1, 1);
+  ct.lookup(3, 3);
+  EXPECT_DOUBLE_EQ(ct.getStats().hitRatioSinceCheckpoint(), 0.75);
+  EXPECT_DOUBLE_EQ(ct.getStats().hitRatioDelta(), 0.25);
+  const auto j = ct.getStats().json();
+  EXPECT_DOUBLE_EQ(j["hit_ratio_delta"].get<double>(), 0.25);
+}
+
+namespace {
+struct SetAssociativeConfig : public dd::DDPackageConfig {
+  static constexpr std::size_t CT_MAT_ADD_NWAYS = 4U;
+  static constexpr std::size_t CT_MAT_MAT_MULT_NWAYS = 4U;
+  static constexpr std::size_t CT_MAT_MAT_MULT_NBUCKET = 64U;
+};
+} // namespace
+
+TEST(DDPackageTest, SetAssociativeComputeTableMatchesDirectMapped) {
+  constexpr std::size_t nq = 4U;
+  auto direct = std::make_unique<dd::Package<>>(nq);
+  auto assoc = std::make_unique<dd::Package<SetAssociativeConfig>>(nq);
+
+  const auto build = [](auto& pkg) {
+    auto e = pkg.makeIdent();
+    for (std::size_t r = 0U; r < 3U; ++r) {
+      for (std::size_t q = 0U; q < nq; ++q) {
+        const auto t = static_cast<dd::Qubit>(q);
+        e = pkg.multiply(pkg.makeGateDD(dd::H_MAT, t), e);
+        e = pkg.multiply(
+            pkg.makeGateDD(dd::X_MAT, qc::Controls{t},
+                           static_cast<dd::Qubit>((q + 1U) % nq)),
+            e);
+        e = pkg.multiply(pkg.makeGateDD(dd::T_MAT, t), e);
+      }
+    }
+    return e;
+  };
+  const auto a = build(*direct);
+  const auto b = build(*assoc);
+  EXPECT_EQ(a.size(), b.size());
+  EXPECT_EQ(a.getMatrix(nq), b.getMatrix(nq));
+  EXPECT_GT(assoc->getMultiplicationComputeTable<dd::mNode>().getStats().hits,
+            0U);
+}
+
+TEST(DDPackageTest, CompactMatrixDD) {
+  constexpr std::size_t nq = 4U;
+  auto dd = std::make_unique<dd::Package<>>(nq);
+  // the controlled gates leave identity-like levels that are skipped
+  auto e = dd->makeGateDD(dd::H_MAT, 3);
+  e = dd->multiply(dd->makeGateDD(dd::X_MAT, qc::Controls{3}, 1), e);
+  e = dd->multiply(dd->makeGateDD(dd::T_MAT, 1), e);
+  e = dd->multiply(dd->makeGateDD(dd::ryMat(0.3), 0), e);
+  dd->incRef(e);
+
+  const dd::CompactMatrixDD compact{e};
+  EXPECT_EQ(compact.size(), e.size());
+  EXPECT_LT(2U * sizeof(dd::CompactMatrixDD::CNode), sizeof(dd::mNode) + 8U);
+
+  const auto mat = e.getMatrix(nq);
+  for (std::size_t i = 0U; i < mat.size(); ++i) {
+    for (std::size_t j = 0U; j < mat.size(); ++j) {
+      const auto v = compact.getValueByIndex(nq, i, j);
+      const auto ref = e.getValueByIndex(nq, i, j);
+      EXPECT_NEAR(std::abs(v - ref), 0., dd::RealNumber::eps);
+    }
+  }
+
+  // rebuilding in the same package yields the very same DD
+  const auto same = compact.toEdge(*dd);
+  EXPECT_EQ(same.p, e.p);
+  EXPECT_TRUE(same.w.approximatelyEquals(e.w));
+
+  // rebuilding in another package yields an equivalent DD
+  auto other = std::make_unique<dd::Package<>>(nq);
+  const auto f = compact.toEdge(*other);
+  EXPECT_EQ(f.size(), e.size());
+  const auto fmat = f.getMatrix(nq);
+  for (std::size_t i = 0U; i < mat.size(); ++i) {
+    for (std::size_t j = 0U; j < mat.size(); ++j) {
+      EXPECT_NEAR(std::abs(fmat[i][j] - mat[i][j]), 0., dd::RealNumber::eps);
+    }
+  }
+}
+
+TEST(DDPackageTest, CompactVectorDD) {
+  constexpr std::size_t nq = 5U;
+  auto dd = std::make_unique<dd::Package<>>(nq);
+  const auto w = dd->makeWState(nq);
+  const dd::CompactVectorDD compact{w};
+  EXPECT_EQ(compact.size(), w.size());
+  for (std::size_t i = 0U; i < (1ULL << nq); ++i) {
+    EXPECT_NEAR(std::abs(compact.getValueByIndex(i) - w.getValueByIndex(i)),
+                0., dd::RealNumber::eps);
+  }
+  EXPECT_EQ(compact.toEdge(*dd), w);
+
+  const dd::CompactVectorDD zero{dd::vEdge::zero()};
+  EXPECT_EQ(zero.size(), 1U);
+  EXPECT_TRUE(zero.getRoot().isZero());
+  EXPECT_EQ(zero.getValueByIndex(3), std::complex<dd::fp>{0.});
+}
+
+namespace {
+struct HugePageArenaConfig : public dd::DDPackageConfig {
+  static constexpr bool MM_HUGE_PAGE_ARENA = true;
+};
+} // namespace
+
+TEST(DDPackageTest, HugePageArenaPackage) {
+  constexpr std::size_t nq = 6U;
+  auto dd = std::make_unique<dd::Package<HugePageArenaConfig>>(nq);
+  EXPECT_TRUE(dd->mMemoryManager.usesArena());
+  EXPECT_EQ(dd->mMemoryManager.getStats().numReservedBytes %
+                dd::MemoryManager<dd::mNode>::HUGE_PAGE_SIZE,
+            0U);
+
+  auto ref = std::make_unique<dd::Package<>>(nq);
+  const auto build = [](auto& pkg) {
+    auto e = pkg.makeIdent();
+    for (std::size_t q = 0U; q < nq; ++q) {
+      const auto t = static_cast<dd::Qubit>(q);
+      e = pkg.multiply(pkg.makeGateDD(dd::H_MAT, t), e);
+      e = pkg.multiply(pkg.makeGateDD(dd::X_MAT, qc::Controls{t},
+                                      static_cast<dd::Qubit>((q + 1U) % nq)),
+                       e);
+    }
+    return e;
+  };
+  auto e = build(*dd);
+  EXPECT_EQ(e.getMatrix(nq), build(*ref).getMatrix(nq));
+
+  dd->incRef(e);
+  dd->decRef(e);
+  dd->garbageCollect(true);
+  EXPECT_EQ(dd->mUniqueTable.getNumEntries(), 0U);
+  EXPECT_GT(dd->mMemoryManager.getStats().peakNumReservedBytes, 0U);
+  const auto stats = dd->mMemoryManager.getStats().json();
+  EXPECT_TRUE(stats.contains("memory_reserved_MiB"));
+}
+
+TEST(DDPackageTest, GarbageCollectionKeepsUnaffectedComputeTableEntries) {
+  auto dd = std::make_unique<dd::Package<>>(2);
+  auto& ct = dd->getMultiplicationComputeTable<dd::mNode>();
+
+  const auto a = dd->makeGateDD(dd::H_MAT, 1);
+  const auto b = dd->makeGateDD(dd::X_MAT, qc::Controls{1}, 0);
+  dd->incRef(a);
+  dd->incRef(b);
+  const auto ab = dd->multiply(a, b);
+  dd->incRef(ab);
+  ASSERT_NE(ct.lookup(a.p, b.p), nullptr);
+  const auto expected = ab.getMatrix(2);
+
+  // garbage that does not share any node with the cached product
+  const auto garbage =
+      dd->multiply(dd->makeGateDD(dd::T_MAT, 0), dd->makeGateDD(dd::Y_MAT, 1));
+  ASSERT_NE(garbage.p, ab.p);
+  EXPECT_TRUE(dd->garbageCollect(true));
+
+  // the product is still cached and the entry is reported as a hit
+  const auto hits = ct.getStats().hits;
+  const auto* cached = ct.lookup(a.p, b.p);
+  ASSERT_NE(cached, nullptr);
+  EXPECT_EQ(cached->p, ab.p);
+  EXPECT_EQ(ct.getStats().hits, hits + 1U);
+
+  // once the result is collected, the entry becomes a miss
+  dd->decRef(ab);
+  EXPECT_TRUE(dd->garbageCollect(true));
+  EXPECT_EQ(ct.lookup(a.p, b.p), nullptr);
+
+  // recomputing yields the same matrix
+  const auto again = dd->multiply(a, b);
+  EXPECT_EQ(again.getMatrix(2), expected);
+}
+
+namespace {
+struct IncrementalGCConfig : public dd::DDPackageConfig {
+  static constexpr bool UT_INCREMENTAL_GC = true;
+};
+struct TimeSlicedGCConfig : public dd::DDPackageConfig {
+  static constexpr bool UT_INCREMENTAL_GC = true;
+  static constexpr std::size_t UT_GC_SLICE_SIZE = 4U;
+};
+struct IncrementalBucketedGCConfig : public SmallBucketedTableConfig {
+  static constexpr bool UT_INCREMENTAL_GC = true;
+};
+
+template <class Config> void checkIncrementalCollection() {
+  constexpr std::size_t nq = 4U;
+  auto dd = std::make_unique<dd::Package<Config>>(nq);
+  auto ref = std::make_unique<dd::Package<>>(nq);
+
+  const auto build = [](auto& pkg) {
+    auto e = pkg.makeIdent();
+    pkg.incRef(e);
+    for (std::size_t r = 0U; r < 3U; ++r) {
+      for (std::size_t q = 0U; q < nq; ++q) {
+        const auto t = static_cast<dd::Qubit>(q);
+        auto next = pkg.multiply(pkg.makeGateDD(dd::H_MAT, t), e);
+        next = pkg.multiply(
+            pkg.makeGateDD(dd::X_MAT, qc::Controls{t},
+                           static_cast<dd::Qubit>((q + 1U) % nq)),
+            next);
+        pkg.incRef(next);
+        pkg.decRef(e);
+        e = next;
+        pkg.garbageCollect(true);
+      }
+    }
+    return e;
+  };
+  const auto a = build(*dd);
+  const auto b = build(*ref);
+  EXPECT_EQ(a.getMatrix(nq), b.getMatrix(nq));
+  // a forced collection frees exactly the nodes a full sweep frees
+  EXPECT_EQ(dd->mUniqueTable.getNumEntries(), ref->mUniqueTable.getNumEntries());
+
+  dd->decRef(a);
+  dd->garbageCollect(true);
+  EXPECT_EQ(dd->mUniqueTable.getNumEntries(), 0U);
+  EXPECT_EQ(dd->mUniqueTable.getNumCollectionCandidates(), 0U);
+}
+} // namespace
+
+TEST(DDPackageTest, IncrementalGarbageCollection) {
+  checkIncrementalCollection<IncrementalGCConfig>();
+  checkIncrementalCollection<IncrementalBucketedGCConfig>();
+}
+
+TEST(DDPackageTest, TimeSlicedGarbageCollection) {
+  checkIncrementalCollection<TimeSlicedGCConfig>();
+
+  auto dd = std::make_unique<dd::Package<>>(1);
+  dd::MemoryManager<dd::vNode> mm{16U};
+  // a tiny table that may be collected as soon as it holds 4 nodes
+  dd::UniqueTable<dd::vNode, 64U> ut{1U, mm, 4U};
+  ut.setIncrementalCollection(true, 3U);
+  for (std::size_t i = 0U; i < 8U; ++i) {
+    auto* p = mm.get();
+    p->v = 0;
+    p->e = {dd::vEdge::terminal(dd->cn.lookup(static_cast<dd::fp>(i + 2U))),
+            dd::vEdge::zero()};
+    std::ignore = ut.lookup(p);
+  }
+  ASSERT_EQ(ut.getNumEntries(), 8U);
+  EXPECT_EQ(ut.getNumCollectionCandidates(), 8U);
+
+  // a non-forced collection only inspects a slice of the candidates
+  EXPECT_EQ(ut.garbageCollect(), 3U);
+  EXPECT_EQ(ut.getNumEntries(), 5U);
+  EXPECT_EQ(ut.getNumCollectionCandidates(), 5U);
+  EXPECT_EQ(ut.garbageCollect(), 3U);
+  // the table dropped below the collection limit
+  EXPECT_EQ(ut.garbageCollect(), 0U);
+  EXPECT_EQ(ut.garbageCollect(true), 2U);
+  EXPECT_EQ(ut.getNumEntries(), 0U);
+  EXPECT_EQ(ut.getNumCollectionCandidates(), 0U);
+}
+
+TEST(DDPackageTest, ParallelMultiplication) {
+  constexpr std::size_t nq = 6U;
+  auto dd = std::make_unique<dd::Package<>>(nq);
+
+  auto u = dd->makeIdent();
+  dd->incRef(u);
+  for (std::size_t q = 0U; q < nq; ++q) {
+    const auto t = static_cast<dd::Qubit>(q);
+    const auto c = static_cast<dd::Qubit>((q + 1U) % nq);
+    for (const auto& g :
+         {dd->makeGateDD(dd::H_MAT, t), dd->makeGateDD(dd::T_MAT, t),
+          dd->makeGateDD(dd::X_MAT, qc::Controls{c}, t),
+          dd->makeGateDD(dd::rzMat(0.1 * static_cast<dd::fp>(q + 1U)), c)}) {
+      auto next = dd->multiply(g, u);
+      dd->incRef(next);
+      dd->decRef(u);
+      u = next;
+    }
+  }
+
+  const auto expected = dd->multiply(u, u);
+  dd->incRef(expected);
+  for (const auto threads : {2U, 3U, 8U}) {
+    for (const auto levels : {1U, 2U, 4U}) {
+      const auto actual = dd->multiplyParallel(u, u, threads, levels);
+      EXPECT_EQ(actual.p, expected.p);
+      EXPECT_TRUE(actual.w.approximatelyEquals(expected.w));
+    }
+  }
+
+  const auto state = dd->multiply(u, dd->makeZeroState(nq));
+  const auto parallelState =
+      dd->multiplyParallel(u, dd->makeZeroState(nq), 4U, 3U);
+  EXPECT_EQ(parallelState.p, state.p);
+  EXPECT_TRUE(parallelState.w.approximatelyEquals(state.w));
+
+  // more levels than qubits and a single thread fall back gracefully
+  const auto deep = dd->multiplyParallel(u, u, 2U, 2U * nq);
+  EXPECT_EQ(deep.p, expected.p);
+  const auto single = dd->multiplyParallel(u, u, 1U);
+  EXPECT_EQ(single.p, expected.p);
+}
+
 TEST(DDPackageTest, SpecialCaseTerminal) {
   auto dd = std::make_unique<dd::Package<>>(2);
   auto one = dd::vEdge::one();
@@ -1638,7 +2462,7 @@ TEST(DDPackageTest, dNoiseCache) {
   dd->incRef(initialState);
 
   // nothing pre-cached
-  const std::vector<dd::Qubit> target = {0};
+  const dd::NoiseQubits target(std::vector<dd::Qubit>{0});
   const auto cachedNoise = dd->densityNoise.lookup(initialState, target);
   ASSERT_EQ(cachedNoise.p, nullptr);
 
@@ -1652,6 +2476,18 @@ TEST(DDPackageTest, dNoiseCache) {
   ASSERT_NE(cachedNoise1.p, nullptr);
   ASSERT_EQ(cachedNoise1.p, state.p);
 
+  // keys do not depend on the container they are built from
+  const auto cachedNoise3 = dd->densityNoise.lookup(
+      initialState, dd::NoiseQubits(std::set<qc::Qubit>{0U}));
+  ASSERT_EQ(cachedNoise3.p, state.p);
+
+  // operations on too many qubits are not cached
+  const dd::NoiseQubits manyQubits(
+      std::vector<dd::Qubit>(dd::NoiseQubits::CAPACITY + 1U, 0U));
+  EXPECT_FALSE(manyQubits.cacheable());
+  dd->densityNoise.insert(initialState, state, manyQubits);
+  EXPECT_EQ(dd->densityNoise.lookup(initialState, manyQubits).p, nullptr);
+
   // no noise pre-cached after clear
   dd->densityNoise.clear();
   const auto cachedNoise2 = dd->densityNoise.lookup(initialState, target);
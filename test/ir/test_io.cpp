@@ -117,6 +117,41 @@ TEST_F(IO, importFromStringReal) {
   std::cout << *qc << "\n";
 }
 
+TEST_F(IO, importStreaming) {
+  const std::string real = ".numvars 4\n.variables a b c d\n"
+                           ".constants --0-\n.garbage ---1\n"
+                           ".begin\nh1 a\nt2 a b\nf2 a d\n.end";
+  std::stringstream ss{real};
+  qc->import(ss, qc::Format::Real);
+
+  std::vector<std::unique_ptr<qc::Operation>> streamed{};
+  qc::QuantumComputation qc2{};
+  std::stringstream ss2{real};
+  qc2.importStreaming(ss2, qc::Format::Real,
+                      [&streamed](std::unique_ptr<qc::Operation> op) {
+                        streamed.emplace_back(std::move(op));
+                      });
+
+  // the operations are passed to the sink instead of being stored
+  EXPECT_TRUE(qc2.empty());
+  ASSERT_EQ(streamed.size(), qc->size());
+  for (std::size_t i = 0U; i < streamed.size(); ++i) {
+    EXPECT_TRUE(streamed[i]->equals(*qc->at(i)));
+  }
+  // the meta information is the same, including which qubits are idle
+  for (qc::Qubit q = 0U; q < 4U; ++q) {
+    EXPECT_EQ(qc2.isIdleQubit(q), qc->isIdleQubit(q));
+  }
+  EXPECT_EQ(qc2.initialLayout, qc->initialLayout);
+  EXPECT_EQ(qc2.outputPermutation, qc->outputPermutation);
+  EXPECT_EQ(qc2.ancillary, qc->ancillary);
+  EXPECT_EQ(qc2.garbage, qc->garbage);
+
+  // appending operations after the import stores them again
+  qc2.h(0);
+  EXPECT_EQ(qc2.size(), 1U);
+}
+
 TEST_F(IO, controlledOpActingOnWholeRegister) {
   EXPECT_THROW(*qc = qc::QuantumComputation::fromQASM("qreg q[2];"
                                                       "cx q,q[1];"),